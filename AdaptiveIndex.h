@@ -0,0 +1,415 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_ADAPTIVEINDEX_H
+#define WET2_ADAPTIVEINDEX_H
+
+#include "library2.h"
+#include "HashTable.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+/**
+ * Direct addressing is used while at least 1/4 of the key cells hold a
+ * record, once the records cover less than 1/16 of the cells (or a new key
+ * would leave them under 1/4) the index falls back to the hash table
+ * Key arrays up to directMinimumSize cells are always allowed
+ */
+const int directMinimumSize = 64;
+const int directMaximumSize = 1 << 30;
+const int directGrowDensity = 4;
+const int directShrinkDensity = 16;
+
+/**
+ * Generic Template Class for an index of records by positive int keys
+ * While the keys are a dense range 1..N every key has a cell in a flat array
+ * holding the position of it's record, so a lookup is two indexed loads, and
+ * the records are packed in a second array sized by the number of records
+ * alone, so a key with no record costs only it's cell
+ * When the keys become sparse every record is moved into a HashTable and the
+ * index keeps using the hash table until it's cleared, the keys of the hash
+ * table aren't tracked so it can't tell when they're dense again, and the
+ * thresholds are far apart so a fallback is paid for by the removals that
+ * made the keys sparse
+ * @tparam T Type of the stored record, must be move constructible
+ * @tparam H Hash policy of the fallback hash table
+ */
+template<class T, class H = SeededHash>
+class AdaptiveIndex {
+private:
+    bool isDirect = true;
+    int numberOfItems = 0;
+    int directSize = 0;
+    int recordCapacity = 0;
+    int minimumCapacity = 0;
+    // The position of the record of every key, -1 for keys with no record
+    int *positions = nullptr;
+    int *keys = nullptr;
+    T *records = nullptr;
+    HashTable<T, H> hashTable;
+
+    void ResizeDirect(int nSize);
+
+    void ResizeRecords(int nCapacity);
+
+    void MoveToHashTable();
+
+    void FreeDirect();
+
+public:
+    explicit AdaptiveIndex(bool incrementalResize = false);
+
+    AdaptiveIndex(const AdaptiveIndex<T, H> &other) = delete;
+
+    AdaptiveIndex<T, H> &operator=(const AdaptiveIndex<T, H> &other) = delete;
+
+    StatusType Insert(int key, T &&data);
+
+    StatusType Find(int key);
+
+    T *FindData(int key);
+
+    void Prefetch(int key);
+
+    StatusType Remove(int key);
+
+    void Clear();
+
+    StatusType Reserve(int numberOfRecords);
+
+    StatusType SetMinimumCapacity(int numberOfRecords);
+
+    bool IsDirect();
+
+    int getSize();
+
+    int getNumberOfPositions();
+
+    T *RecordAt(int position);
+
+    ~AdaptiveIndex();
+};
+
+/**
+ * Creates an empty index in direct addressing mode
+ * @tparam T Type of the stored record
+ * @param incrementalResize Resize mode of the fallback hash table
+ */
+template<class T, class H>
+AdaptiveIndex<T, H>::AdaptiveIndex(bool incrementalResize): hashTable(incrementalResize) {
+    ResizeDirect(directMinimumSize);
+}
+
+/**
+ * Moves the positions of the keys into a new array of the given size
+ * @param nSize The new number of key cells, larger than every stored key
+ */
+template<class T, class H>
+void AdaptiveIndex<T, H>::ResizeDirect(int nSize) {
+    int *nPositions = new int[nSize];
+    // Every byte of -1 is 0xFF
+    memset(nPositions, 0xFF, sizeof(int) * nSize);
+    if (positions) {
+        std::copy(positions, positions + directSize, nPositions);
+    }
+    delete[] positions;
+    positions = nPositions;
+    directSize = nSize;
+}
+
+/**
+ * Moves the packed records into a new array of the given capacity
+ * @param nCapacity The new number of records the array has room for, at
+ * least the number of records
+ */
+template<class T, class H>
+void AdaptiveIndex<T, H>::ResizeRecords(int nCapacity) {
+    int *nKeys = new int[nCapacity];
+    T *nRecords = static_cast<T *>(::operator new(sizeof(T) * nCapacity));
+    for (int i = 0; i < numberOfItems; ++i) {
+        new(&nRecords[i]) T(std::move(records[i]));
+        records[i].~T();
+        nKeys[i] = keys[i];
+    }
+    delete[] keys;
+    ::operator delete(records);
+    keys = nKeys;
+    records = nRecords;
+    recordCapacity = nCapacity;
+}
+
+/**
+ * Destroys the direct records and releases the direct arrays
+ */
+template<class T, class H>
+void AdaptiveIndex<T, H>::FreeDirect() {
+    for (int i = 0; i < numberOfItems; ++i) {
+        records[i].~T();
+    }
+    delete[] positions;
+    delete[] keys;
+    ::operator delete(records);
+    positions = nullptr;
+    keys = nullptr;
+    records = nullptr;
+    directSize = 0;
+    recordCapacity = 0;
+}
+
+/**
+ * Leaves direct addressing mode, moving every record into the hash table
+ */
+template<class T, class H>
+void AdaptiveIndex<T, H>::MoveToHashTable() {
+    hashTable.SetMinimumCapacity(minimumCapacity);
+    hashTable.Reserve(numberOfItems);
+    for (int i = 0; i < numberOfItems; ++i) {
+        hashTable.Insert(keys[i], std::move(records[i]));
+    }
+    FreeDirect();
+    isDirect = false;
+}
+
+template<class T, class H>
+StatusType AdaptiveIndex<T, H>::Insert(int key, T &&data) {
+    if (isDirect && key >= directSize) {
+        // Growing the array to cover the new key, as long as it stays dense
+        long long nSize = directSize;
+        while (nSize <= key) {
+            nSize *= 2;
+        }
+        if (nSize <= directMaximumSize && (long long) (numberOfItems + 1) * directGrowDensity >= nSize) {
+            ResizeDirect((int) nSize);
+        } else {
+            MoveToHashTable();
+        }
+    } else if (isDirect && key <= 0) {
+        MoveToHashTable();
+    }
+    if (!isDirect) {
+        StatusType result = hashTable.Insert(key, std::move(data));
+        if (result == SUCCESS) {
+            numberOfItems++;
+        }
+        return result;
+    }
+    if (positions[key] >= 0) {
+        // The key already exists in the index
+        return FAILURE;
+    }
+    if (numberOfItems == recordCapacity) {
+        ResizeRecords(std::max(recordCapacity * 2, directMinimumSize));
+    }
+    new(&records[numberOfItems]) T(std::move(data));
+    keys[numberOfItems] = key;
+    positions[key] = numberOfItems;
+    numberOfItems++;
+    return SUCCESS;
+}
+
+template<class T, class H>
+StatusType AdaptiveIndex<T, H>::Find(int key) {
+    if (FindData(key)) {
+        return SUCCESS;
+    }
+    return FAILURE;
+}
+
+/**
+ * Returns a pointer to the record stored with the input key
+ * The pointer is only valid until the next insertion or removal
+ * @tparam T Type of the stored record
+ * @param key The key of the record
+ * @return A pointer to the record if it exists, nullptr otherwise
+ */
+template<class T, class H>
+T *AdaptiveIndex<T, H>::FindData(int key) {
+    if (isDirect) {
+        if ((unsigned int) key < (unsigned int) directSize && positions[key] >= 0) {
+            return &records[positions[key]];
+        }
+        return nullptr;
+    }
+    return hashTable.FindData(key);
+}
+
+/**
+ * Issues prefetches for the memory a lookup of the key will read
+ * @tparam T Type of the stored record
+ * @param key The key that will be looked up
+ */
+template<class T, class H>
+void AdaptiveIndex<T, H>::Prefetch(int key) {
+    if (!isDirect) {
+        hashTable.Prefetch(key);
+    } else if ((unsigned int) key < (unsigned int) directSize) {
+        // The position isn't known before it's loaded, only it's cell is
+        // fetched ahead
+        __builtin_prefetch(positions + key);
+    }
+}
+
+template<class T, class H>
+StatusType AdaptiveIndex<T, H>::Remove(int key) {
+    if (!isDirect) {
+        StatusType result = hashTable.Remove(key);
+        if (result == SUCCESS) {
+            numberOfItems--;
+        }
+        return result;
+    }
+    if ((unsigned int) key >= (unsigned int) directSize || positions[key] < 0) {
+        // The key doesn't exist in the index
+        return FAILURE;
+    }
+    // The last record fills the hole so the records stay packed
+    int position = positions[key];
+    int last = numberOfItems - 1;
+    records[position].~T();
+    if (position != last) {
+        new(&records[position]) T(std::move(records[last]));
+        records[last].~T();
+        keys[position] = keys[last];
+        positions[keys[position]] = position;
+    }
+    positions[key] = -1;
+    numberOfItems--;
+    if (directSize > directMinimumSize && (long long) minimumCapacity * 2 < directSize &&
+        (long long) numberOfItems * directShrinkDensity < directSize) {
+        // Most of the range was removed, the array is no longer worth it's memory
+        MoveToHashTable();
+    } else if (recordCapacity > directMinimumSize && recordCapacity / 2 >= minimumCapacity &&
+               numberOfItems * 4 < recordCapacity) {
+        ResizeRecords(recordCapacity / 2);
+    }
+    return SUCCESS;
+}
+
+/**
+ * Removes every record, the index goes back to direct addressing and keeps
+ * room for it's minimum capacity
+ * @tparam T Type of the stored record
+ */
+template<class T, class H>
+void AdaptiveIndex<T, H>::Clear() {
+    if (isDirect) {
+        for (int i = 0; i < numberOfItems; ++i) {
+            positions[keys[i]] = -1;
+            records[i].~T();
+        }
+        numberOfItems = 0;
+    } else {
+        hashTable.Clear();
+        numberOfItems = 0;
+        isDirect = true;
+        ResizeDirect(directMinimumSize);
+        Reserve(minimumCapacity);
+    }
+}
+
+/**
+ * Makes room for the given number of records, in direct mode this assumes the
+ * keys will be 1..numberOfRecords, the key cells cover them and the records
+ * array has room for exactly that many
+ * @param numberOfRecords The number of records to make room for
+ * @return INVALID_INPUT for a negative number of records, SUCCESS otherwise
+ */
+template<class T, class H>
+StatusType AdaptiveIndex<T, H>::Reserve(int numberOfRecords) {
+    if (numberOfRecords < 0) {
+        return INVALID_INPUT;
+    }
+    if (!isDirect) {
+        return hashTable.Reserve(numberOfRecords);
+    }
+    long long nSize = directSize;
+    while (nSize <= numberOfRecords) {
+        nSize *= 2;
+    }
+    if (nSize > directMaximumSize) {
+        MoveToHashTable();
+        return hashTable.Reserve(numberOfRecords);
+    }
+    if (nSize > directSize) {
+        ResizeDirect((int) nSize);
+    }
+    if (numberOfRecords > recordCapacity) {
+        ResizeRecords(numberOfRecords);
+    }
+    return SUCCESS;
+}
+
+/**
+ * Keeps room for the given number of records for the lifetime of the index
+ * @param numberOfRecords The number of records to always keep room for
+ * @return INVALID_INPUT for a negative number of records, SUCCESS otherwise
+ */
+template<class T, class H>
+StatusType AdaptiveIndex<T, H>::SetMinimumCapacity(int numberOfRecords) {
+    if (numberOfRecords < 0) {
+        return INVALID_INPUT;
+    }
+    minimumCapacity = numberOfRecords;
+    if (!isDirect) {
+        return hashTable.SetMinimumCapacity(numberOfRecords);
+    }
+    return Reserve(numberOfRecords);
+}
+
+/**
+ * Checks if the index still uses direct addressing
+ * @return True while the records are stored in the direct array
+ */
+template<class T, class H>
+bool AdaptiveIndex<T, H>::IsDirect() {
+    return isDirect;
+}
+
+/**
+ * Returns the number of key cells of the structure currently in use
+ */
+template<class T, class H>
+int AdaptiveIndex<T, H>::getSize() {
+    if (isDirect) {
+        return directSize;
+    }
+    return hashTable.getSize();
+}
+
+/**
+ * Returns the number of positions a scan of the records with RecordAt visits
+ */
+template<class T, class H>
+int AdaptiveIndex<T, H>::getNumberOfPositions() {
+    if (isDirect) {
+        return numberOfItems;
+    }
+    return hashTable.getNumberOfPositions();
+}
+
+/**
+ * Returns the record at a position of a scan over every record, the
+ * positions stay valid until the next insertion or removal
+ * @tparam T Type of the stored record
+ * @param position A position below getNumberOfPositions()
+ * @return A pointer to the record at the position, nullptr if it holds none
+ */
+template<class T, class H>
+T *AdaptiveIndex<T, H>::RecordAt(int position) {
+    if (isDirect) {
+        return &records[position];
+    }
+    return hashTable.RecordAt(position);
+}
+
+template<class T, class H>
+AdaptiveIndex<T, H>::~AdaptiveIndex() {
+    if (isDirect) {
+        FreeDirect();
+    }
+}
+
+#endif //WET2_ADAPTIVEINDEX_H
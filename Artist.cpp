@@ -4,9 +4,107 @@
 
 #include "Artist.h"
 
-Artist::Artist(int artistID) : artistID(artistID), numberOfSongs(0), bestSong(nullptr) {
-    songsByIdTree = Tree<Song>();
-    songsByPlaysTree = RankTree<TwoParamKey, Song>();
+/**
+ * Opens a relocation pass over the arenas of the songs and the tree nodes
+ */
+void ArtistPools::BeginRelocation() {
+    songs.BeginRelocation();
+    songsById.BeginRelocation();
+    songsByPlays.BeginRelocation();
+}
+
+/**
+ * Closes the relocation pass and releases the chunks it emptied
+ */
+void ArtistPools::EndRelocation() {
+    songs.EndRelocation();
+    songsById.EndRelocation();
+    songsByPlays.EndRelocation();
+}
+
+/**
+ * Frees the songs and the tree nodes of every artist using the pools at once,
+ * every such artist must have forgotten it's trees first
+ */
+void ArtistPools::Clear() {
+    songs.Clear();
+    songsById.Clear();
+    songsByPlays.Clear();
+}
+
+Artist::Artist(int artistID, ArtistPools *pools) : artistID(artistID), numberOfSongs(0), bestSongID(0), isSmall(true),
+                                                   isPurged(false), pools(pools), songsByIdTree(&pools->songsById),
+                                                   songsByPlaysTree(&pools->songsByPlays) {
+}
+
+/**
+ * Searches for a song in the inline arrays
+ * @param songID The ID of the song
+ * @return The position of the song if it exists, -1 otherwise
+ */
+int Artist::FindSmallSong(int songID) const {
+    for (int i = 0; i < numberOfSongs; ++i) {
+        if (smallSongIDs[i] >= songID) {
+            return smallSongIDs[i] == songID ? i : -1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Moves the songs from the inline arrays into the trees
+ */
+void Artist::PromoteToTrees() {
+    for (int i = 0; i < numberOfSongs; ++i) {
+        int songID = smallSongIDs[i];
+        int plays = smallSongPlays[i];
+        songsByIdTree.Insert(songID, new (&pools->songs) Song(songID, artistID, plays));
+        songsByPlaysTree.Insert(TwoParamKey(plays, songID));
+    }
+    isSmall = false;
+}
+
+/**
+ * Moves the songs from the trees back into the inline arrays and deletes the
+ * trees' nodes
+ */
+void Artist::DemoteToArray() {
+    // The plays tree is ordered by plays, the arrays are ordered by song ID
+    int count = 0;
+    for (const TwoParamKey &key : songsByPlaysTree) {
+        int position = count++;
+        while (position > 0 && smallSongIDs[position - 1] > key.getSongId()) {
+            smallSongIDs[position] = smallSongIDs[position - 1];
+            smallSongPlays[position] = smallSongPlays[position - 1];
+            position--;
+        }
+        smallSongIDs[position] = key.getSongId();
+        smallSongPlays[position] = key.getNumberOfPlays();
+    }
+    songsByIdTree = ArtistSongsById(&pools->songsById);
+    songsByPlaysTree = ArtistSongRanking(&pools->songsByPlays);
+    isSmall = true;
+}
+
+/**
+ * Finds the song with the most plays, the one with the lowest ID among
+ * songs with the same number of plays
+ */
+void Artist::UpdateBestSong() {
+    if (numberOfSongs == 0) {
+        bestSongID = 0;
+    } else if (!isSmall) {
+        bestSongID = songsByPlaysTree.GetRoot()->findMaxNoRank()->getKey().getSongId();
+    } else {
+        // The arrays are ordered by ID, so only more plays replace the best song
+        int best = 0;
+        for (int i = 1; i < numberOfSongs; ++i) {
+            if (smallSongPlays[i] > smallSongPlays[best]) {
+                best = i;
+            }
+        }
+        bestSongID = smallSongIDs[best];
+    }
 }
 
 int Artist::getArtistId() const {
@@ -17,28 +115,464 @@ int Artist::getNumberOfSongs() const {
     return numberOfSongs;
 }
 
-Song *Artist::getBestSong() const {
-    return bestSong;
+/**
+ * Returns the ID of the artist's song with the most plays, 0 if the artist
+ * has no songs
+ */
+int Artist::getBestSongId() const {
+    return bestSongID;
 }
 
-Tree<Song> &Artist::getSongsByIdTree() {
-    return songsByIdTree;
+/**
+ * Checks if the songs are stored in the inline arrays
+ * @return True while the artist has few enough songs to keep them inline
+ */
+bool Artist::IsSmall() const {
+    return isSmall;
 }
 
-RankTree<TwoParamKey, Song> &Artist::getSongsByPlaysTree() {
-    return songsByPlaysTree;
+bool Artist::IsPurged() const {
+    return isPurged;
 }
 
-void Artist::setArtistId(int artistId) {
-    artistID = artistId;
+void Artist::setPurged(bool nIsPurged) {
+    isPurged = nIsPurged;
+}
+
+bool Artist::HasSong(int songID) {
+    if (isSmall) {
+        return FindSmallSong(songID) >= 0;
+    }
+    return songsByIdTree.FindData(songID) != nullptr;
+}
+
+/**
+ * Adds a new song with no plays, the song must not already exist
+ * @param songID The ID of the new song
+ */
+void Artist::AddSong(int songID) {
+    if (isSmall && numberOfSongs == smallArtistCapacity) {
+        PromoteToTrees();
+    }
+    if (isSmall) {
+        int position = numberOfSongs;
+        while (position > 0 && smallSongIDs[position - 1] > songID) {
+            smallSongIDs[position] = smallSongIDs[position - 1];
+            smallSongPlays[position] = smallSongPlays[position - 1];
+            position--;
+        }
+        smallSongIDs[position] = songID;
+        smallSongPlays[position] = 0;
+    } else {
+        songsByIdTree.Insert(songID, new (&pools->songs) Song(songID, artistID, 0));
+        songsByPlaysTree.Insert(TwoParamKey(0, songID));
+    }
+    numberOfSongs++;
+    UpdateBestSong();
+}
+
+/**
+ * Adds many new songs with no plays, the songs must not already exist
+ * Songs that fit in the inline arrays are merged into them, otherwise the trees
+ * are rebuilt from the merged sorted songs in linear time unless the artist
+ * already has more songs than are being added, where inserting every new song
+ * into the existing trees is cheaper
+ * @param songIDs The IDs of the new songs, sorted and without duplicates
+ * @param numberOfNewSongs The number of new songs
+ */
+void Artist::AddSongs(const int *songIDs, int numberOfNewSongs) {
+    if (numberOfNewSongs <= 0) {
+        return;
+    }
+    if (isSmall && numberOfSongs + numberOfNewSongs <= smallArtistCapacity) {
+        // Merging from the back so every song moves at most once
+        int position = numberOfSongs + numberOfNewSongs;
+        int oldIndex = numberOfSongs - 1;
+        for (int newIndex = numberOfNewSongs - 1; newIndex >= 0; --newIndex) {
+            while (oldIndex >= 0 && smallSongIDs[oldIndex] > songIDs[newIndex]) {
+                position--;
+                smallSongIDs[position] = smallSongIDs[oldIndex];
+                smallSongPlays[position] = smallSongPlays[oldIndex];
+                oldIndex--;
+            }
+            position--;
+            smallSongIDs[position] = songIDs[newIndex];
+            smallSongPlays[position] = 0;
+        }
+        numberOfSongs += numberOfNewSongs;
+    } else if (!isSmall && numberOfNewSongs < numberOfSongs) {
+        for (int i = 0; i < numberOfNewSongs; ++i) {
+            songsByIdTree.Insert(songIDs[i], new (&pools->songs) Song(songIDs[i], artistID, 0));
+            songsByPlaysTree.Insert(TwoParamKey(0, songIDs[i]));
+        }
+        numberOfSongs += numberOfNewSongs;
+    } else {
+        RebuildTrees(songIDs, numberOfNewSongs);
+    }
+    UpdateBestSong();
+}
+
+/**
+ * Replaces the trees with trees built from the current songs and the new songs
+ * The current songs are read in ID order and in plays order, and each order is
+ * merged with the new songs, so both trees are built from sorted arrays
+ * @param songIDs The IDs of the new songs, sorted and without duplicates
+ * @param numberOfNewSongs The number of new songs
+ */
+void Artist::RebuildTrees(const int *songIDs, int numberOfNewSongs) {
+    int total = numberOfSongs + numberOfNewSongs;
+    int *oldIDs = new int[numberOfSongs + 1];
+    int *oldPlays = new int[numberOfSongs + 1];
+    TwoParamKey *oldKeys = new TwoParamKey[numberOfSongs + 1];
+    FillSongsById(oldIDs, oldPlays);
+    FillSongsByPlays(oldKeys);
+
+    int *ids = new int[total];
+    int *plays = new int[total];
+    TwoParamKey *keys = new TwoParamKey[total];
+    // Merging the new songs into the ID order
+    int oldIndex = 0;
+    int newIndex = 0;
+    for (int i = 0; i < total; ++i) {
+        if (newIndex == numberOfNewSongs || (oldIndex < numberOfSongs && oldIDs[oldIndex] < songIDs[newIndex])) {
+            ids[i] = oldIDs[oldIndex];
+            plays[i] = oldPlays[oldIndex];
+            oldIndex++;
+        } else {
+            ids[i] = songIDs[newIndex];
+            plays[i] = 0;
+            newIndex++;
+        }
+    }
+    // Merging the new songs into the plays order, among songs with no plays
+    // a lower ID is a greater key, so the new songs are read from the back
+    oldIndex = 0;
+    newIndex = numberOfNewSongs - 1;
+    for (int i = 0; i < total; ++i) {
+        if (newIndex < 0 || (oldIndex < numberOfSongs && oldKeys[oldIndex] < TwoParamKey(0, songIDs[newIndex]))) {
+            keys[i] = oldKeys[oldIndex];
+            oldIndex++;
+        } else {
+            keys[i] = TwoParamKey(0, songIDs[newIndex]);
+            newIndex--;
+        }
+    }
+    delete[] oldIDs;
+    delete[] oldPlays;
+    delete[] oldKeys;
+    BuildTrees(ids, plays, keys, total);
+    delete[] ids;
+    delete[] plays;
+    delete[] keys;
+}
+
+/**
+ * Replaces the songs of the artist with songs given in both orders, building
+ * the trees from the sorted arrays, or the inline arrays if the songs fit
+ * @param songIDs The IDs of the songs, sorted
+ * @param plays The number of plays of every song in songIDs
+ * @param keys The songs ordered by plays
+ * @param total The number of songs
+ */
+void Artist::BuildTrees(const int *songIDs, const int *plays, const TwoParamKey *keys, int total) {
+    if (total <= smallArtistCapacity) {
+        songsByIdTree = ArtistSongsById(&pools->songsById);
+        songsByPlaysTree = ArtistSongRanking(&pools->songsByPlays);
+        std::copy(songIDs, songIDs + total, smallSongIDs);
+        std::copy(plays, plays + total, smallSongPlays);
+        isSmall = true;
+        numberOfSongs = total;
+        return;
+    }
+    Song **songsById = new Song *[total];
+    for (int i = 0; i < total; ++i) {
+        songsById[i] = new (&pools->songs) Song(songIDs[i], artistID, plays[i]);
+    }
+    songsByIdTree = ArtistSongsById(songIDs, songsById, total, &pools->songsById);
+    songsByPlaysTree = ArtistSongRanking(keys, total, &pools->songsByPlays);
+    delete[] songsById;
+    isSmall = false;
+    numberOfSongs = total;
 }
 
-void Artist::setNumberOfSongs(int NumberOfSongs) {
-    Artist::numberOfSongs = NumberOfSongs;
+/**
+ * Fills arrays with the songs of the artist ordered by ID
+ * @param songIDs The array to fill with the IDs, as large as the number of songs
+ * @param plays The array to fill with the number of plays of every song
+ */
+void Artist::FillSongsById(int *songIDs, int *plays) {
+    if (isSmall) {
+        std::copy(smallSongIDs, smallSongIDs + numberOfSongs, songIDs);
+        std::copy(smallSongPlays, smallSongPlays + numberOfSongs, plays);
+        return;
+    }
+    Song **songs = new Song *[numberOfSongs];
+    songsByIdTree.FillArrWithDataInOrder(songs);
+    for (int i = 0; i < numberOfSongs; ++i) {
+        songIDs[i] = songs[i]->getSongId();
+        plays[i] = songs[i]->getNumberOfPlays();
+    }
+    delete[] songs;
 }
 
-void Artist::setBestSong(Song *BestSong) {
-    Artist::bestSong = BestSong;
+/**
+ * Fills an array with the songs of the artist ordered by plays, from the
+ * worst song to the best one
+ * @param keys The array to fill, as large as the number of songs
+ */
+void Artist::FillSongsByPlays(TwoParamKey *keys) {
+    if (isSmall) {
+        // At most smallArtistCapacity songs, sorting them by plays is cheap
+        for (int i = 0; i < numberOfSongs; ++i) {
+            TwoParamKey key(smallSongPlays[i], smallSongIDs[i]);
+            int position = i;
+            while (position > 0 && key < keys[position - 1]) {
+                keys[position] = keys[position - 1];
+                position--;
+            }
+            keys[position] = key;
+        }
+        return;
+    }
+    for (const TwoParamKey &key : songsByPlaysTree) {
+        *keys++ = key;
+    }
+}
+
+/**
+ * Moves all the songs of another artist to this artist, leaving the other
+ * artist with no songs, in O(n + m) if the artists share no songs
+ * Both artists' songs are read in ID order and in plays order and merged, a
+ * song both artists have gets the plays of both, and the trees are rebuilt
+ * from the merged arrays
+ * @param other The artist to take the songs from
+ */
+void Artist::MergeSongsFrom(Artist &other) {
+    int n = numberOfSongs;
+    int m = other.numberOfSongs;
+    int *ids = new int[n + m + 1];
+    int *plays = new int[n + m + 1];
+    int *otherIDs = new int[m + 1];
+    int *otherPlays = new int[m + 1];
+    TwoParamKey *keys = new TwoParamKey[n + 1];
+    TwoParamKey *otherKeys = new TwoParamKey[m + 1];
+    FillSongsById(ids + m, plays + m);
+    other.FillSongsById(otherIDs, otherPlays);
+    FillSongsByPlays(keys);
+    other.FillSongsByPlays(otherKeys);
+
+    // Merging by ID into the front of the arrays, this artist's songs were
+    // placed after room for the other artist's songs so they are never
+    // overwritten before they are read
+    int *sharedIDs = new int[std::min(n, m) + 1];
+    TwoParamKey *sharedKeys = new TwoParamKey[std::min(n, m) + 1];
+    int numberOfShared = 0;
+    int total = 0;
+    int index = m;
+    int otherIndex = 0;
+    while (index < n + m || otherIndex < m) {
+        if (otherIndex == m || (index < n + m && ids[index] < otherIDs[otherIndex])) {
+            ids[total] = ids[index];
+            plays[total++] = plays[index++];
+        } else if (index == n + m || otherIDs[otherIndex] < ids[index]) {
+            ids[total] = otherIDs[otherIndex];
+            plays[total++] = otherPlays[otherIndex++];
+        } else {
+            sharedIDs[numberOfShared] = ids[index];
+            sharedKeys[numberOfShared++] = TwoParamKey(plays[index] + otherPlays[otherIndex], ids[index]);
+            ids[total] = ids[index];
+            plays[total++] = plays[index++] + otherPlays[otherIndex++];
+        }
+    }
+    // The shared songs moved in the plays order, they are merged in separately
+    std::sort(sharedKeys, sharedKeys + numberOfShared);
+    TwoParamKey *mergedKeys = new TwoParamKey[total + 1];
+    int mergedSize = 0;
+    index = 0;
+    otherIndex = 0;
+    int sharedIndex = 0;
+    while (mergedSize < total) {
+        while (index < n && std::binary_search(sharedIDs, sharedIDs + numberOfShared, keys[index].getSongId())) {
+            index++;
+        }
+        while (otherIndex < m &&
+               std::binary_search(sharedIDs, sharedIDs + numberOfShared, otherKeys[otherIndex].getSongId())) {
+            otherIndex++;
+        }
+        const TwoParamKey *next = sharedIndex < numberOfShared ? &sharedKeys[sharedIndex] : nullptr;
+        if (index < n && (!next || keys[index] < *next)) {
+            next = &keys[index];
+        }
+        if (otherIndex < m && (!next || otherKeys[otherIndex] < *next)) {
+            next = &otherKeys[otherIndex];
+        }
+        if (next == &keys[index]) {
+            index++;
+        } else if (next == &otherKeys[otherIndex]) {
+            otherIndex++;
+        } else {
+            sharedIndex++;
+        }
+        mergedKeys[mergedSize++] = *next;
+    }
+    BuildTrees(ids, plays, mergedKeys, total);
+    other.BuildTrees(ids, plays, mergedKeys, 0);
+    UpdateBestSong();
+    other.UpdateBestSong();
+    delete[] ids;
+    delete[] plays;
+    delete[] otherIDs;
+    delete[] otherPlays;
+    delete[] keys;
+    delete[] otherKeys;
+    delete[] sharedIDs;
+    delete[] sharedKeys;
+    delete[] mergedKeys;
+}
+
+/**
+ * Removes a song from the artist
+ * @param songID The ID of the song
+ * @return The number of plays the song had, -1 if the song doesn't exist
+ */
+int Artist::RemoveSong(int songID) {
+    int plays;
+    if (isSmall) {
+        int position = FindSmallSong(songID);
+        if (position < 0) {
+            return -1;
+        }
+        plays = smallSongPlays[position];
+        for (int i = position; i < numberOfSongs - 1; ++i) {
+            smallSongIDs[i] = smallSongIDs[i + 1];
+            smallSongPlays[i] = smallSongPlays[i + 1];
+        }
+        numberOfSongs--;
+    } else {
+        Song *song = songsByIdTree.FindData(songID);
+        if (!song) {
+            return -1;
+        }
+        plays = song->getNumberOfPlays();
+        songsByIdTree.Remove(songID);
+        songsByPlaysTree.Remove(TwoParamKey(plays, songID));
+        numberOfSongs--;
+        if (numberOfSongs <= smallArtistDemoteSize) {
+            DemoteToArray();
+        }
+    }
+    UpdateBestSong();
+    return plays;
+}
+
+/**
+ * Removes every song with fewer plays than the input number
+ * The songs are one range of the plays tree and are cut from it in
+ * O(log n + k), only the songs by ID tree loses them one by one
+ * @param numberOfPlays The minimal number of plays of a kept song
+ * @return The number of removed songs
+ */
+int Artist::RemoveSongsWithPlaysBelow(int numberOfPlays) {
+    int removed = 0;
+    if (isSmall) {
+        int kept = 0;
+        for (int i = 0; i < numberOfSongs; ++i) {
+            if (smallSongPlays[i] >= numberOfPlays) {
+                smallSongIDs[kept] = smallSongIDs[i];
+                smallSongPlays[kept++] = smallSongPlays[i];
+            }
+        }
+        removed = numberOfSongs - kept;
+    } else {
+        // Among songs with the same plays a higher ID is a smaller key
+        ArtistSongRanking range = songsByPlaysTree.ExtractRange(TwoParamKey(INT_MIN, INT_MAX),
+                                                                          TwoParamKey(numberOfPlays, INT_MAX));
+        for (const TwoParamKey &key : range) {
+            songsByIdTree.Remove(key.getSongId());
+            removed++;
+        }
+    }
+    numberOfSongs -= removed;
+    if (!isSmall && numberOfSongs <= smallArtistDemoteSize) {
+        DemoteToArray();
+    }
+    if (removed > 0) {
+        UpdateBestSong();
+    }
+    return removed;
+}
+
+/**
+ * Adds to the number of plays of a song
+ * @param songID The ID of the song
+ * @param count The number of plays to add
+ * @param songFromId The song as stored in the songs by ID tree if it was
+ * already looked up, nullptr otherwise
+ * @return The number of plays the song had before, -1 if the song doesn't exist
+ */
+int Artist::AddToSongCount(int songID, int count, Song *songFromId) {
+    int oldNumberOfPlays;
+    if (isSmall) {
+        int position = FindSmallSong(songID);
+        if (position < 0) {
+            return -1;
+        }
+        oldNumberOfPlays = smallSongPlays[position];
+        smallSongPlays[position] = oldNumberOfPlays + count;
+    } else {
+        if (!songFromId) {
+            songFromId = songsByIdTree.FindData(songID);
+            if (!songFromId) {
+                return -1;
+            }
+        }
+        oldNumberOfPlays = songFromId->getNumberOfPlays();
+        int newNumberOfPlays = oldNumberOfPlays + count;
+        songFromId->setNumberOfPlays(newNumberOfPlays);
+        songsByPlaysTree.Remove(TwoParamKey(oldNumberOfPlays, songID));
+        songsByPlaysTree.Insert(TwoParamKey(newNumberOfPlays, songID));
+    }
+    UpdateBestSong();
+    return oldNumberOfPlays;
+}
+
+/**
+ * Moves the nodes of the artist's trees and their songs to the lowest free
+ * slots of their arenas, the songs by ID tree first
+ * @param byIdCursor The position of the pass in the songs by ID tree
+ * @param byPlaysCursor The position of the pass in the songs by plays tree
+ * @param budget The number of songs this slice may still visit, decreased by
+ * the songs visited
+ * @return True if the pass reached the end of both trees
+ */
+bool Artist::RelocateNodes(RelocationCursor<int> &byIdCursor, RelocationCursor<TwoParamKey> &byPlaysCursor,
+                           int &budget) {
+    if (isSmall) {
+        // The songs are in the inline arrays, there are no nodes to move
+        return true;
+    }
+    return songsByIdTree.RelocateNodes(byIdCursor, budget) && songsByPlaysTree.RelocateNodes(byPlaysCursor, budget);
+}
+
+/**
+ * Forgets the songs in the artist's trees without deleting them, leaving the
+ * trees empty, the songs must be released by clearing the pools
+ */
+void Artist::MarkTreesAsNullptr() {
+    songsByIdTree.MarkRootAsNullptr();
+    songsByPlaysTree.MarkRootAsNullptr();
+}
+
+ArtistSongsById &Artist::getSongsByIdTree() {
+    return songsByIdTree;
+}
+
+ArtistSongRanking &Artist::getSongsByPlaysTree() {
+    return songsByPlaysTree;
+}
+
+void Artist::setArtistId(int artistId) {
+    artistID = artistId;
 }
 
 void Artist::compareNumberOfSongs() {
@@ -50,4 +584,3 @@ void Artist::compareNumberOfSongs() {
                   << songsByPlaysTree.GetRoot()->getRank() << std::endl;
     }
 }
-
@@ -6,36 +6,115 @@
 #define WET2_ARTIST_H
 
 
-#include "Tree.h"
+#include <algorithm>
+#include <climits>
+#include "BTree.h"
+#include "RankTree.h"
 #include "Song.h"
 #include "TwoParamKey.h"
 
+/**
+ * An artist keeps up to smallArtistCapacity songs in inline arrays sorted by
+ * song ID, past that it's songs move to the songs by ID and songs by plays
+ * trees, and move back once a removal leaves smallArtistDemoteSize songs
+ * The gap between the two sizes keeps an artist from moving it's songs on
+ * every add and remove around the threshold
+ */
+const int smallArtistCapacity = 16;
+const int smallArtistDemoteSize = smallArtistCapacity / 2;
+
+typedef BTree<Song, LibraryNodeStorage> ArtistSongsById;
+typedef RankTree<TwoParamKey, void, AvlBalance, LibraryNodeStorage> ArtistSongRanking;
+
+/**
+ * The pools of the songs and the tree nodes of artists, every artist of a
+ * music manager allocates from the pools the manager owns
+ */
+struct ArtistPools {
+    LibraryNodeStorage::Pool<Song> songs;
+    ArtistSongsById::NodePool songsById;
+    ArtistSongRanking::NodePool songsByPlays;
+
+    void BeginRelocation();
+
+    void EndRelocation();
+
+    void Clear();
+};
+
 class Artist {
 private:
     int artistID;
     int numberOfSongs;
-    Song *bestSong;
-    Tree<Song> songsByIdTree;
-    RankTree<TwoParamKey, Song> songsByPlaysTree;
+    int bestSongID;
+    bool isSmall;
+    // Set while a purge of the songs below some number of plays has already
+    // handled the artist
+    bool isPurged;
+    int smallSongIDs[smallArtistCapacity];
+    int smallSongPlays[smallArtistCapacity];
+    ArtistPools *pools;
+    ArtistSongsById songsByIdTree;
+    ArtistSongRanking songsByPlaysTree;
+
+    int FindSmallSong(int songID) const;
+
+    void PromoteToTrees();
+
+    void DemoteToArray();
+
+    void RebuildTrees(const int *songIDs, int numberOfNewSongs);
+
+    void BuildTrees(const int *songIDs, const int *plays, const TwoParamKey *keys, int total);
+
+    void UpdateBestSong();
 
 public:
-    explicit Artist(int artistID);
+    Artist(int artistID, ArtistPools *pools);
+
+    Artist(Artist &&other) = default;
+
+    Artist &operator=(Artist &&other) = default;
 
     int getArtistId() const;
 
     int getNumberOfSongs() const;
 
-    Song *getBestSong() const;
+    int getBestSongId() const;
 
-    Tree<Song> &getSongsByIdTree();
+    bool IsSmall() const;
 
-    RankTree<TwoParamKey, Song> &getSongsByPlaysTree();
+    bool IsPurged() const;
 
-    void setArtistId(int artistId);
+    void setPurged(bool nIsPurged);
+
+    bool HasSong(int songID);
 
-    void setNumberOfSongs(int numberOfSongs);
+    void AddSong(int songID);
 
-    void setBestSong(Song *bestSong);
+    void AddSongs(const int *songIDs, int numberOfNewSongs);
+
+    void MergeSongsFrom(Artist &other);
+
+    void FillSongsById(int *songIDs, int *plays);
+
+    void FillSongsByPlays(TwoParamKey *keys);
+
+    int RemoveSong(int songID);
+
+    int RemoveSongsWithPlaysBelow(int numberOfPlays);
+
+    int AddToSongCount(int songID, int count, Song *songFromId = nullptr);
+
+    bool RelocateNodes(RelocationCursor<int> &byIdCursor, RelocationCursor<TwoParamKey> &byPlaysCursor, int &budget);
+
+    void MarkTreesAsNullptr();
+
+    ArtistSongsById &getSongsByIdTree();
+
+    ArtistSongRanking &getSongsByPlaysTree();
+
+    void setArtistId(int artistId);
 
     void compareNumberOfSongs();
 
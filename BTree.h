@@ -0,0 +1,793 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_BTREE_H
+#define WET2_BTREE_H
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "NodeStorage.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Every node other than the root holds between bTreeMinDegree - 1 and
+ * bTreeMaxKeys keys
+ * The key array is padded to a whole number of SIMD blocks, unused cells hold
+ * bTreeKeyPadding so they never compare as smaller than a searched key
+ */
+const int bTreeMinDegree = 16;
+const int bTreeMaxKeys = 2 * bTreeMinDegree - 1;
+const int bTreeKeySlots = bTreeMaxKeys + 1;
+const int bTreeKeyPadding = INT_MAX;
+
+template<class T, class S>
+class BTree;
+
+/**
+ * Generic Template Class for a BTreeNode
+ * A wide node of a B-tree storing sorted int keys and pointers to dynamically
+ * allocated user data, the keys are kept in their own array so a node search
+ * only reads the first two cache lines of the node
+ * Deleting a node does not delete it's data or children
+ * @tparam T Type of the data stored in the node
+ */
+template<class T, class S = PointerStorage>
+class BTreeNode : public S::template NodeBase<BTreeNode<T, S>> {
+private:
+    int keys[bTreeKeySlots];
+    int numberOfKeys = 0;
+    bool isLeaf;
+    T *data[bTreeMaxKeys];
+    BTreeNode<T, S> *children[bTreeMaxKeys + 1];
+
+    void InsertEntry(int position, int key, T *entryData, BTreeNode<T, S> *rightChild);
+
+    void RemoveEntry(int position);
+
+    friend class BTree<T, S>;
+
+public:
+    explicit BTreeNode(bool isLeaf);
+
+    BTreeNode(const BTreeNode<T, S> &other) = delete;
+
+    BTreeNode<T, S> &operator=(const BTreeNode<T, S> &other) = delete;
+
+    int LowerBound(int key) const;
+
+    void Prefetch() const;
+
+    int getNumberOfKeys() const;
+
+    int getKey(int position) const;
+
+    T *getData(int position) const;
+
+    BTreeNode<T, S> *getChild(int position) const;
+
+    bool IsLeaf() const;
+};
+
+/**
+ * =============================================================================
+ * B-Tree Node Functions Implementation
+ * =============================================================================
+ */
+
+/**
+ * Creates an empty node
+ * @tparam T Type of the data stored in the node
+ * @param isLeaf True if the node has no children
+ */
+template<class T, class S>
+BTreeNode<T, S>::BTreeNode(bool isLeaf): isLeaf(isLeaf) {
+    std::fill(keys, keys + bTreeKeySlots, bTreeKeyPadding);
+}
+
+/**
+ * Counts the keys of the node that are smaller than the input key, which is
+ * the position of the key in the node if it exists, or the child to descend to
+ * otherwise
+ * Uses SSE2 compares over the whole padded key array when available
+ * @tparam T Type of the data stored in the node
+ * @param key The key to search for
+ * @return The number of keys in the node smaller than the input key
+ */
+template<class T, class S>
+int BTreeNode<T, S>::LowerBound(int key) const {
+#ifdef __SSE2__
+    __m128i target = _mm_set1_epi32(key);
+    __m128i count = _mm_setzero_si128();
+    for (int i = 0; i < bTreeKeySlots; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+        // Every smaller key sets it's lane to -1
+        count = _mm_sub_epi32(count, _mm_cmplt_epi32(block, target));
+    }
+    count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(1, 0, 3, 2)));
+    count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(count);
+#else
+    int position = 0;
+    while (position < numberOfKeys && keys[position] < key) {
+        position++;
+    }
+    return position;
+#endif
+}
+
+/**
+ * Issues prefetches for the part of the node a search reads
+ * @tparam T Type of the data stored in the node
+ */
+template<class T, class S>
+void BTreeNode<T, S>::Prefetch() const {
+    __builtin_prefetch(keys);
+    __builtin_prefetch(keys + bTreeKeySlots - 1);
+}
+
+/**
+ * Inserts a key with it's data at the input position, moving the following
+ * keys one position to the right
+ * The node must not be full
+ * @tparam T Type of the data stored in the node
+ * @param position The position of the new key
+ * @param key The new key
+ * @param entryData The data of the new key
+ * @param rightChild The child holding the keys between the new key and the
+ * next one, ignored in leaves
+ */
+template<class T, class S>
+void BTreeNode<T, S>::InsertEntry(int position, int key, T *entryData, BTreeNode<T, S> *rightChild) {
+    int moved = numberOfKeys - position;
+    memmove(keys + position + 1, keys + position, sizeof(int) * moved);
+    memmove(data + position + 1, data + position, sizeof(T *) * moved);
+    keys[position] = key;
+    data[position] = entryData;
+    if (!isLeaf) {
+        memmove(children + position + 2, children + position + 1, sizeof(BTreeNode<T, S> *) * moved);
+        children[position + 1] = rightChild;
+    }
+    numberOfKeys++;
+}
+
+/**
+ * Removes the key at the input position along with the child to it's right,
+ * without deleting it's data
+ * @tparam T Type of the data stored in the node
+ * @param position The position of the key to remove
+ */
+template<class T, class S>
+void BTreeNode<T, S>::RemoveEntry(int position) {
+    int moved = numberOfKeys - position - 1;
+    memmove(keys + position, keys + position + 1, sizeof(int) * moved);
+    memmove(data + position, data + position + 1, sizeof(T *) * moved);
+    if (!isLeaf) {
+        memmove(children + position + 1, children + position + 2, sizeof(BTreeNode<T, S> *) * moved);
+    }
+    numberOfKeys--;
+    keys[numberOfKeys] = bTreeKeyPadding;
+}
+
+template<class T, class S>
+int BTreeNode<T, S>::getNumberOfKeys() const {
+    return numberOfKeys;
+}
+
+template<class T, class S>
+int BTreeNode<T, S>::getKey(int position) const {
+    return keys[position];
+}
+
+template<class T, class S>
+T *BTreeNode<T, S>::getData(int position) const {
+    return data[position];
+}
+
+template<class T, class S>
+BTreeNode<T, S> *BTreeNode<T, S>::getChild(int position) const {
+    return children[position];
+}
+
+template<class T, class S>
+bool BTreeNode<T, S>::IsLeaf() const {
+    return isLeaf;
+}
+
+/**
+ * Generic Template Class for a B-Tree
+ * An ordered index of dynamically allocated user data by int keys with the
+ * same interface and ownership rules as Tree, every node holds up to
+ * bTreeMaxKeys keys so a search touches a few wide nodes instead of one node
+ * per tree level
+ * Insertions split full nodes and removals fill small nodes on the way down,
+ * so both are done in a single pass from the root
+ * @tparam T Type of the stored data, deleted when it's key is removed
+ */
+template<class T, class S = PointerStorage>
+class BTree {
+public:
+    typedef typename S::template Pool<BTreeNode<T, S>> NodePool;
+
+private:
+    BTreeNode<T, S> *root = nullptr;
+    int numberOfItems = 0;
+    NodePool *pool;
+
+    static void SplitChild(BTreeNode<T, S> *node, int position);
+
+    static void MergeChildren(BTreeNode<T, S> *node, int position);
+
+    static int FillChild(BTreeNode<T, S> *node, int position);
+
+    static void DeleteNodes(BTreeNode<T, S> *node);
+
+    static long long MaxKeysOfHeight(int height);
+
+    static BTreeNode<T, S> *BuildSubtree(const int *keys, T **data, int size, int height, int minimumChildren,
+                                         NodePool *pool);
+
+    static void FillArrWithDataInOrder(BTreeNode<T, S> *node, T **&array);
+
+    static bool RelocateSubtree(BTreeNode<T, S> *&node, RelocationCursor<int> &cursor, int &budget);
+
+public:
+    explicit BTree(NodePool *pool = nullptr);
+
+    BTree(const int *keys, T **data, int size, NodePool *pool = nullptr);
+
+    BTree(const BTree<T, S> &other) = delete;
+
+    BTree(BTree<T, S> &&other) noexcept;
+
+    BTree<T, S> &operator=(const BTree<T, S> &other) = delete;
+
+    BTree<T, S> &operator=(BTree<T, S> &&other) noexcept;
+
+    BTreeNode<T, S> *GetRoot();
+
+    T *FindData(int key);
+
+    void Insert(int key, T *data = nullptr);
+
+    void Remove(int key);
+
+    bool IsRootNull();
+
+    int getSize();
+
+    void FillArrWithDataInOrder(T **array);
+
+    bool RelocateNodes(RelocationCursor<int> &cursor, int &budget);
+
+    void MarkRootAsNullptr();
+
+    ~BTree();
+};
+
+/**
+ * =============================================================================
+ * B-Tree Functions Implementation
+ * =============================================================================
+ */
+
+/**
+ * Creates an empty tree
+ * @tparam T Type of the stored data
+ * @param pool The pool to allocate the nodes from
+ */
+template<class T, class S>
+BTree<T, S>::BTree(NodePool *pool): pool(pool) {}
+
+/**
+ * Takes ownership of the nodes of another tree, leaving the other tree empty
+ * @tparam T Type of the stored data
+ * @param other The tree to move the nodes from
+ */
+template<class T, class S>
+BTree<T, S>::BTree(BTree<T, S> &&other) noexcept: root(other.root), numberOfItems(other.numberOfItems),
+                                                  pool(other.pool) {
+    other.root = nullptr;
+    other.numberOfItems = 0;
+}
+
+/**
+ * Deletes the nodes of this tree and takes ownership of the nodes of another
+ * tree, leaving the other tree empty
+ * @tparam T Type of the stored data
+ * @param other The tree to move the nodes from
+ * @return A reference to this tree
+ */
+template<class T, class S>
+BTree<T, S> &BTree<T, S>::operator=(BTree<T, S> &&other) noexcept {
+    if (this != &other) {
+        DeleteNodes(root);
+        root = other.root;
+        numberOfItems = other.numberOfItems;
+        pool = other.pool;
+        other.root = nullptr;
+        other.numberOfItems = 0;
+    }
+    return *this;
+}
+
+/**
+ * Splits a full child of the node into two nodes, moving it's median key up
+ * into the node
+ * @tparam T Type of the stored data
+ * @param node A node that is not full
+ * @param position The position of the full child
+ */
+template<class T, class S>
+void BTree<T, S>::SplitChild(BTreeNode<T, S> *node, int position) {
+    BTreeNode<T, S> *child = node->children[position];
+    BTreeNode<T, S> *sibling = new (S::PoolOf(child)) BTreeNode<T, S>(child->isLeaf);
+    // The upper half of the child moves to the new sibling
+    memcpy(sibling->keys, child->keys + bTreeMinDegree, sizeof(int) * (bTreeMinDegree - 1));
+    memcpy(sibling->data, child->data + bTreeMinDegree, sizeof(T *) * (bTreeMinDegree - 1));
+    if (!child->isLeaf) {
+        memcpy(sibling->children, child->children + bTreeMinDegree, sizeof(BTreeNode<T, S> *) * bTreeMinDegree);
+    }
+    sibling->numberOfKeys = bTreeMinDegree - 1;
+    int medianKey = child->keys[bTreeMinDegree - 1];
+    T *medianData = child->data[bTreeMinDegree - 1];
+    std::fill(child->keys + bTreeMinDegree - 1, child->keys + bTreeMaxKeys, bTreeKeyPadding);
+    child->numberOfKeys = bTreeMinDegree - 1;
+    node->InsertEntry(position, medianKey, medianData, sibling);
+}
+
+/**
+ * Merges the child at the input position with it's right sibling, moving the
+ * key between them down into the merged node
+ * Both children must hold bTreeMinDegree - 1 keys
+ * @tparam T Type of the stored data
+ * @param node The parent of the two children
+ * @param position The position of the left child
+ */
+template<class T, class S>
+void BTree<T, S>::MergeChildren(BTreeNode<T, S> *node, int position) {
+    BTreeNode<T, S> *child = node->children[position];
+    BTreeNode<T, S> *sibling = node->children[position + 1];
+    int count = child->numberOfKeys;
+    child->keys[count] = node->keys[position];
+    child->data[count] = node->data[position];
+    memcpy(child->keys + count + 1, sibling->keys, sizeof(int) * sibling->numberOfKeys);
+    memcpy(child->data + count + 1, sibling->data, sizeof(T *) * sibling->numberOfKeys);
+    if (!child->isLeaf) {
+        memcpy(child->children + count + 1, sibling->children, sizeof(BTreeNode<T, S> *) * (sibling->numberOfKeys + 1));
+    }
+    child->numberOfKeys += sibling->numberOfKeys + 1;
+    node->RemoveEntry(position);
+    delete sibling;
+}
+
+/**
+ * Makes sure the child at the input position has at least bTreeMinDegree keys
+ * before the removal descends into it, by borrowing a key from a sibling or
+ * merging with one
+ * @tparam T Type of the stored data
+ * @param node The parent of the child
+ * @param position The position of the child
+ * @return The position of the child to descend into after the fill
+ */
+template<class T, class S>
+int BTree<T, S>::FillChild(BTreeNode<T, S> *node, int position) {
+    BTreeNode<T, S> *child = node->children[position];
+    if (position > 0 && node->children[position - 1]->numberOfKeys >= bTreeMinDegree) {
+        // Rotating the last key of the left sibling through the parent
+        BTreeNode<T, S> *sibling = node->children[position - 1];
+        memmove(child->keys + 1, child->keys, sizeof(int) * child->numberOfKeys);
+        memmove(child->data + 1, child->data, sizeof(T *) * child->numberOfKeys);
+        if (!child->isLeaf) {
+            memmove(child->children + 1, child->children, sizeof(BTreeNode<T, S> *) * (child->numberOfKeys + 1));
+            child->children[0] = sibling->children[sibling->numberOfKeys];
+        }
+        child->keys[0] = node->keys[position - 1];
+        child->data[0] = node->data[position - 1];
+        child->numberOfKeys++;
+        node->keys[position - 1] = sibling->keys[sibling->numberOfKeys - 1];
+        node->data[position - 1] = sibling->data[sibling->numberOfKeys - 1];
+        sibling->numberOfKeys--;
+        sibling->keys[sibling->numberOfKeys] = bTreeKeyPadding;
+        return position;
+    }
+    if (position < node->numberOfKeys && node->children[position + 1]->numberOfKeys >= bTreeMinDegree) {
+        // Rotating the first key of the right sibling through the parent
+        BTreeNode<T, S> *sibling = node->children[position + 1];
+        child->keys[child->numberOfKeys] = node->keys[position];
+        child->data[child->numberOfKeys] = node->data[position];
+        if (!child->isLeaf) {
+            child->children[child->numberOfKeys + 1] = sibling->children[0];
+            memmove(sibling->children, sibling->children + 1, sizeof(BTreeNode<T, S> *) * sibling->numberOfKeys);
+        }
+        child->numberOfKeys++;
+        node->keys[position] = sibling->keys[0];
+        node->data[position] = sibling->data[0];
+        memmove(sibling->keys, sibling->keys + 1, sizeof(int) * (sibling->numberOfKeys - 1));
+        memmove(sibling->data, sibling->data + 1, sizeof(T *) * (sibling->numberOfKeys - 1));
+        sibling->numberOfKeys--;
+        sibling->keys[sibling->numberOfKeys] = bTreeKeyPadding;
+        return position;
+    }
+    if (position < node->numberOfKeys) {
+        MergeChildren(node, position);
+        return position;
+    }
+    MergeChildren(node, position - 1);
+    return position - 1;
+}
+
+/**
+ * Deletes the subtree of the input node, including all of it's data
+ * @tparam T Type of the stored data
+ * @param node The root of the subtree
+ */
+template<class T, class S>
+void BTree<T, S>::DeleteNodes(BTreeNode<T, S> *node) {
+    if (!node) {
+        return;
+    }
+    for (int i = 0; i < node->numberOfKeys; ++i) {
+        delete node->data[i];
+    }
+    if (!node->isLeaf) {
+        for (int i = 0; i <= node->numberOfKeys; ++i) {
+            DeleteNodes(node->children[i]);
+        }
+    }
+    delete node;
+}
+
+/**
+ * Returns the maximal number of keys in a subtree of the input height, where
+ * a leaf has height 0
+ * @tparam T Type of the stored data
+ */
+template<class T, class S>
+long long BTree<T, S>::MaxKeysOfHeight(int height) {
+    long long maxKeys = bTreeMaxKeys;
+    for (int level = 0; level < height; ++level) {
+        maxKeys = maxKeys * (bTreeMaxKeys + 1) + bTreeMaxKeys;
+    }
+    return maxKeys;
+}
+
+/**
+ * Builds a subtree with all of it's leaves at the input height from sorted keys
+ * The keys with the separator after every child are spread evenly over the
+ * fewest children that can hold them, so every node stays within the node size
+ * limits without any splits
+ * @tparam T Type of the stored data
+ * @param keys The sorted keys of the subtree
+ * @param data The data of every key
+ * @param size The number of keys
+ * @param height The height of the subtree
+ * @param minimumChildren The number of children the subtree's root must have
+ * @param pool The pool to allocate the nodes from
+ * @return The root of the new subtree
+ */
+template<class T, class S>
+BTreeNode<T, S> *BTree<T, S>::BuildSubtree(const int *keys, T **data, int size, int height, int minimumChildren,
+                                           NodePool *pool) {
+    BTreeNode<T, S> *node = new (pool) BTreeNode<T, S>(height == 0);
+    if (height == 0) {
+        memcpy(node->keys, keys, sizeof(int) * size);
+        memcpy(node->data, data, sizeof(T *) * size);
+        node->numberOfKeys = size;
+        return node;
+    }
+    // Every child takes the slots of it's keys and of the separator after it
+    long long childSlots = MaxKeysOfHeight(height - 1) + 1;
+    int numberOfChildren = std::max((int) ((size + childSlots) / childSlots), minimumChildren);
+    int slots = size + 1;
+    int position = 0;
+    for (int i = 0; i < numberOfChildren; ++i) {
+        int childSize = slots / numberOfChildren + (i < slots % numberOfChildren ? 1 : 0) - 1;
+        node->children[i] = BuildSubtree(keys + position, data + position, childSize, height - 1, bTreeMinDegree,
+                                         pool);
+        position += childSize;
+        if (i < numberOfChildren - 1) {
+            node->keys[i] = keys[position];
+            node->data[i] = data[position];
+            position++;
+        }
+    }
+    node->numberOfKeys = numberOfChildren - 1;
+    return node;
+}
+
+/**
+ * Creates a tree holding the input keys in O(size), with no splits
+ * @tparam T Type of the stored data
+ * @param keys The keys of the tree, sorted and without duplicates
+ * @param data The data of every key, the tree takes ownership of it
+ * @param size The number of keys
+ * @param pool The pool to allocate the nodes from
+ */
+template<class T, class S>
+BTree<T, S>::BTree(const int *keys, T **data, int size, NodePool *pool): numberOfItems(size), pool(pool) {
+    if (size <= 0) {
+        numberOfItems = 0;
+        return;
+    }
+    int height = 0;
+    while (MaxKeysOfHeight(height) < size) {
+        height++;
+    }
+    root = BuildSubtree(keys, data, size, height, 2, pool);
+}
+
+/**
+ * Fills an array with the data of the subtree ordered by key
+ * @tparam T Type of the stored data
+ * @param node The root of the subtree
+ * @param array The next cell to fill, moved past the filled cells
+ */
+template<class T, class S>
+void BTree<T, S>::FillArrWithDataInOrder(BTreeNode<T, S> *node, T **&array) {
+    for (int i = 0; i < node->numberOfKeys; ++i) {
+        if (!node->isLeaf) {
+            FillArrWithDataInOrder(node->children[i], array);
+        }
+        *array++ = node->data[i];
+    }
+    if (!node->isLeaf) {
+        FillArrWithDataInOrder(node->children[node->numberOfKeys], array);
+    }
+}
+
+/**
+ * Fills an array with the data of the tree ordered by key
+ * Array should be as large as the tree
+ * @tparam T Type of the stored data
+ * @param array The array to fill
+ */
+template<class T, class S>
+void BTree<T, S>::FillArrWithDataInOrder(T **array) {
+    if (root) {
+        FillArrWithDataInOrder(root, array);
+    }
+}
+
+/**
+ * Returns a pointer to the root of the tree
+ * @tparam T Type of the stored data
+ * @return A pointer to the root of the tree, nullptr if the tree is empty
+ */
+template<class T, class S>
+BTreeNode<T, S> *BTree<T, S>::GetRoot() {
+    return root;
+}
+
+/**
+ * Searches for the data stored with the input key
+ * @tparam T Type of the stored data
+ * @param key The key to search for
+ * @return A pointer to the data if the key is in the tree, nullptr otherwise
+ */
+template<class T, class S>
+T *BTree<T, S>::FindData(int key) {
+    BTreeNode<T, S> *node = root;
+    while (node) {
+        int position = node->LowerBound(key);
+        if (position < node->numberOfKeys && node->keys[position] == key) {
+            return node->data[position];
+        }
+        if (node->isLeaf) {
+            return nullptr;
+        }
+        node = node->children[position];
+    }
+    return nullptr;
+}
+
+/**
+ * Inserts a new key with the given data to the tree
+ * If the key already exists in the tree, nothing will be done
+ * (This also means the dynamic data sent to the function will not
+ * be freed)
+ * @tparam T Type of the stored data
+ * @param key The key of the new data
+ * @param data The data to store
+ */
+template<class T, class S>
+void BTree<T, S>::Insert(int key, T *data) {
+    if (!root) {
+        root = new (pool) BTreeNode<T, S>(true);
+    } else if (root->numberOfKeys == bTreeMaxKeys) {
+        // Splitting a full root is the only way the tree grows in height
+        BTreeNode<T, S> *newRoot = new (pool) BTreeNode<T, S>(false);
+        newRoot->children[0] = root;
+        root = newRoot;
+        SplitChild(root, 0);
+    }
+    BTreeNode<T, S> *node = root;
+    while (true) {
+        int position = node->LowerBound(key);
+        if (position < node->numberOfKeys && node->keys[position] == key) {
+            // The input key already exists in the tree
+            return;
+        }
+        if (node->isLeaf) {
+            node->InsertEntry(position, key, data, nullptr);
+            numberOfItems++;
+            return;
+        }
+        if (node->children[position]->numberOfKeys == bTreeMaxKeys) {
+            // Splitting the full child so it has room if the key ends up in it
+            SplitChild(node, position);
+            if (node->keys[position] == key) {
+                return;
+            } else if (node->keys[position] < key) {
+                position++;
+            }
+        }
+        node = node->children[position];
+    }
+}
+
+/**
+ * Removes a key from the tree and deletes it's data
+ * A key found in an inner node trades places with it's predecessor or
+ * successor leaf key, the descent then keeps going down to that leaf where it
+ * is removed
+ * @tparam T Type of the stored data
+ * @param key The key to remove
+ */
+template<class T, class S>
+void BTree<T, S>::Remove(int key) {
+    BTreeNode<T, S> *node = root;
+    while (node) {
+        int position = node->LowerBound(key);
+        bool isFound = position < node->numberOfKeys && node->keys[position] == key;
+        if (isFound && node->isLeaf) {
+            delete node->data[position];
+            node->RemoveEntry(position);
+            numberOfItems--;
+            break;
+        }
+        if (node->isLeaf) {
+            // The key doesn't exist in the tree
+            break;
+        }
+        if (isFound) {
+            BTreeNode<T, S> *leftChild = node->children[position];
+            BTreeNode<T, S> *rightChild = node->children[position + 1];
+            if (leftChild->numberOfKeys >= bTreeMinDegree) {
+                // The key is swapped with the maximum of the left subtree, where
+                // it stays the largest key and will be found at the end of the
+                // rightmost leaf
+                BTreeNode<T, S> *leaf = leftChild;
+                while (!leaf->isLeaf) {
+                    leaf = leaf->children[leaf->numberOfKeys];
+                }
+                int last = leaf->numberOfKeys - 1;
+                std::swap(node->keys[position], leaf->keys[last]);
+                std::swap(node->data[position], leaf->data[last]);
+                node = leftChild;
+            } else if (rightChild->numberOfKeys >= bTreeMinDegree) {
+                // Symmetric to the left case, using the minimum of the right subtree
+                BTreeNode<T, S> *leaf = rightChild;
+                while (!leaf->isLeaf) {
+                    leaf = leaf->children[0];
+                }
+                std::swap(node->keys[position], leaf->keys[0]);
+                std::swap(node->data[position], leaf->data[0]);
+                node = rightChild;
+            } else {
+                // Both children are minimal, the key moves down into their merge
+                MergeChildren(node, position);
+                node = leftChild;
+            }
+            continue;
+        }
+        if (node->children[position]->numberOfKeys < bTreeMinDegree) {
+            position = FillChild(node, position);
+        }
+        node = node->children[position];
+    }
+    if (root && root->numberOfKeys == 0) {
+        // The root lost it's last key, the tree shrinks in height
+        BTreeNode<T, S> *oldRoot = root;
+        root = root->isLeaf ? nullptr : root->children[0];
+        delete oldRoot;
+    }
+}
+
+/**
+ * Checks if the tree is empty
+ * @tparam T Type of the stored data
+ * @return True if the tree has no keys, False otherwise
+ */
+template<class T, class S>
+bool BTree<T, S>::IsRootNull() {
+    return (root == nullptr);
+}
+
+/**
+ * Returns the number of keys stored in the tree
+ */
+template<class T, class S>
+int BTree<T, S>::getSize() {
+    return numberOfItems;
+}
+
+/**
+ * Moves the nodes of a subtree and their data to the lowest free slots of
+ * their arenas, a node is moved when the pass enters it and it's keys are
+ * visited in ascending order starting at the cursor
+ * The nodes hold no parent pointers, so only the link of the parent (passed
+ * by reference) is fixed
+ * @tparam T Type of the stored data
+ * @param node The link to the root of the subtree
+ * @param cursor The position of the pass, updated when the budget runs out
+ * @param budget The number of keys the slice may still visit
+ * @return True if the pass reached the end of the subtree
+ */
+template<class T, class S>
+bool BTree<T, S>::RelocateSubtree(BTreeNode<T, S> *&node, RelocationCursor<int> &cursor, int &budget) {
+    node = S::template Relocate<BTreeNode<T, S>>(node);
+    // Children before the cursor hold only keys the pass already visited
+    int position = cursor.isStarted ? node->LowerBound(cursor.nextKey) : 0;
+    for (; position <= node->numberOfKeys; ++position) {
+        if (!node->isLeaf && !RelocateSubtree(node->children[position], cursor, budget)) {
+            return false;
+        }
+        if (position == node->numberOfKeys) {
+            break;
+        }
+        if (budget <= 0) {
+            cursor.nextKey = node->keys[position];
+            cursor.isStarted = true;
+            return false;
+        }
+        budget--;
+        node->data[position] = RelocateData<S>(node->data[position]);
+    }
+    return true;
+}
+
+/**
+ * Moves the nodes and their data to the lowest free slots of their arenas in
+ * ascending key order, so the nodes that move end up in dense runs
+ * @tparam T Type of the stored data
+ * @param cursor The position of the pass in this tree, updated when the
+ * budget runs out and reset when the pass reaches the end of the tree
+ * @param budget The number of keys this slice may still visit, decreased by
+ * the keys visited
+ * @return True if the pass reached the end of the tree
+ */
+template<class T, class S>
+bool BTree<T, S>::RelocateNodes(RelocationCursor<int> &cursor, int &budget) {
+    if (root && !RelocateSubtree(root, cursor, budget)) {
+        return false;
+    }
+    cursor = RelocationCursor<int>();
+    return true;
+}
+
+/**
+ * Forgets the nodes of the tree without deleting them, leaving it empty
+ * @tparam T Type of the stored data
+ */
+template<class T, class S>
+void BTree<T, S>::MarkRootAsNullptr() {
+    root = nullptr;
+    numberOfItems = 0;
+}
+
+/**
+ * Deletes all nodes stored in the tree, including the dynamic data stored in them
+ * @tparam T Type of the stored data
+ */
+template<class T, class S>
+BTree<T, S>::~BTree() {
+    DeleteNodes(root);
+    root = nullptr;
+}
+
+#endif //WET2_BTREE_H
@@ -0,0 +1,566 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_BALANCEPOLICY_H
+#define WET2_BALANCEPOLICY_H
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Balancing policies for RankTree
+ * A policy owns the balance field of the nodes and restores it's invariant
+ * whenever the tree links or unlinks nodes, the tree itself keeps the keys,
+ * ranks, sizes and tombstones the same way for every policy
+ * The policy works on the private fields of the node, which names it as a
+ * friend, through these static functions:
+ * Init(node) sets the state of a new single node
+ * Update(node) recomputes the state of a node whose children were rotated
+ * InitBuilt(node, depth, partialDepth) sets the state of a node of a tree
+ * built balanced, after it's children, partialDepth is the depth of the only
+ * level of the tree which may be partial
+ * AfterInsert(node) fixes the tree above a new leaf, the ranks of it's
+ * ancestors are stale, and returns the root
+ * BeforeRemove(node) may move a node down before it is unlinked
+ * AfterRemove(child, parent, isLeftChild, removedBalance) fixes the tree after
+ * a node was unlinked, child took it's place under parent and removedBalance
+ * is the state of the place that was removed, the ranks from parent up are
+ * stale, returns the root
+ * JoinWithPivot(left, pivot, right) joins two trees around a single node
+ * The links of a node are pointers or 32 bit links from NodeStorage.h, so the
+ * helpers that read a linked node take any pointer like P
+ */
+
+/**
+ * AVL balancing, the balance field is the height of the node and the heights
+ * of siblings differ by at most one
+ */
+struct AvlBalance {
+    template<class P>
+    static int Height(const P &node) {
+        return node ? node->balance : 0;
+    }
+
+    template<class N>
+    static void Init(N *node) {
+        node->balance = 1;
+    }
+
+    template<class N>
+    static void Update(N *node) {
+        node->balance = 1 + std::max(Height(node->left), Height(node->right));
+    }
+
+    template<class N>
+    static void InitBuilt(N *node, int, int) {
+        Update(node);
+    }
+
+    template<class N>
+    static N *AfterInsert(N *node) {
+        return Retrace<N>(node->parent);
+    }
+
+    template<class N>
+    static void BeforeRemove(N *) {}
+
+    template<class N>
+    static N *AfterRemove(N *child, N *parent, bool, int) {
+        N *top = Retrace(parent);
+        return top ? top : child;
+    }
+
+    /**
+     * Rotates an unbalanced node, the heights of it's children are expected
+     * to be up to date
+     * @return The new root of the subtree
+     */
+    template<class N>
+    static N *Rebalance(N *node) {
+        int balanceFactor = Height(node->left) - Height(node->right);
+        if (balanceFactor < -1) {
+            // The tree is right heavy
+            if (Height(node->right->left) > Height(node->right->right)) {
+                node->right->LeftRotate();
+            }
+            return node->RightRotate();
+        } else if (balanceFactor > 1) {
+            // The tree is left heavy
+            if (Height(node->left->left) < Height(node->left->right)) {
+                node->left->RightRotate();
+            }
+            return node->LeftRotate();
+        }
+        return node;
+    }
+
+    /**
+     * Walks from the input node up to the root after an insertion or removal
+     * below it, fixing heights and rotating unbalanced nodes
+     * Height updates stop at the first node whose height did not change since
+     * nothing above it can become unbalanced
+     * The ranks of all the ancestors are recounted from their children, which
+     * is correct however many live nodes and tombstones moved under them
+     * @param node The lowest node whose subtree changed
+     * @return The root of the tree if the walk reached it, nullptr otherwise
+     */
+    template<class N>
+    static N *Retrace(N *node) {
+        bool heightChanged = true;
+        N *top = nullptr;
+        while (node) {
+            node->updateNodeRank();
+            if (heightChanged) {
+                int oldHeight = node->balance;
+                Update(node);
+                node = Rebalance(node);
+                heightChanged = (node->balance != oldHeight);
+            }
+            top = node;
+            node = node->parent;
+        }
+        return top;
+    }
+
+    /**
+     * The pivot hangs on the spine of the taller tree where the heights of the
+     * two sides meet, so only the nodes above it are retraced and the join
+     * takes O(difference of heights + 1)
+     */
+    template<class N>
+    static N *JoinWithPivot(N *left, N *pivot, N *right) {
+        int leftHeight = Height(left);
+        int rightHeight = Height(right);
+        pivot->parent = nullptr;
+        if (leftHeight > rightHeight + 1) {
+            // Walking down the right spine of the left tree to a subtree as
+            // short as the right tree, the pivot takes it's place
+            N *spineNode = left;
+            while (spineNode->right && spineNode->right->balance > rightHeight + 1) {
+                spineNode = spineNode->right;
+            }
+            pivot->left = spineNode->right;
+            pivot->right = right;
+            if (pivot->left) {
+                pivot->left->parent = pivot;
+            }
+            if (right) {
+                right->parent = pivot;
+            }
+            Update(pivot);
+            pivot->updateNodeRank();
+            spineNode->right = pivot;
+            pivot->parent = spineNode;
+            return Retrace(spineNode);
+        }
+        if (rightHeight > leftHeight + 1) {
+            N *spineNode = right;
+            while (spineNode->left && spineNode->left->balance > leftHeight + 1) {
+                spineNode = spineNode->left;
+            }
+            pivot->right = spineNode->left;
+            pivot->left = left;
+            if (pivot->right) {
+                pivot->right->parent = pivot;
+            }
+            if (left) {
+                left->parent = pivot;
+            }
+            Update(pivot);
+            pivot->updateNodeRank();
+            spineNode->left = pivot;
+            pivot->parent = spineNode;
+            return Retrace(spineNode);
+        }
+        // The heights are close enough for the pivot to be the new root
+        pivot->left = left;
+        pivot->right = right;
+        if (left) {
+            left->parent = pivot;
+        }
+        if (right) {
+            right->parent = pivot;
+        }
+        Update(pivot);
+        pivot->updateNodeRank();
+        return pivot;
+    }
+};
+
+/**
+ * Red-black balancing, the balance field is the color of the node, a red node
+ * has no red children and every path down to a null has as many black nodes
+ * Fixing up an insertion takes at most two rotations and a removal at most
+ * three, the recolorings above them don't touch the links
+ * The root may be red until a fix or a join blackens it
+ */
+struct RedBlackBalance {
+    static const int black = 0;
+    static const int red = 1;
+
+    template<class P>
+    static bool IsRed(const P &node) {
+        return node && node->balance == red;
+    }
+
+    template<class N>
+    static void Init(N *node) {
+        node->balance = red;
+    }
+
+    template<class N>
+    static void Update(N *) {}
+
+    /**
+     * A tree built balanced has it's nulls on the partial level and the level
+     * above it, coloring only the partial level red evens the black heights
+     */
+    template<class N>
+    static void InitBuilt(N *node, int depth, int partialDepth) {
+        node->balance = (depth == partialDepth) ? red : black;
+    }
+
+    template<class N>
+    static N *Top(N *node) {
+        while (node->parent) {
+            node = node->parent;
+        }
+        return node;
+    }
+
+    /**
+     * Counts the black nodes on the left spine, O(log n)
+     */
+    template<class N>
+    static int BlackHeight(N *node) {
+        int height = 0;
+        for (; node; node = node->left) {
+            if (!IsRed(node)) {
+                height++;
+            }
+        }
+        return height;
+    }
+
+    /**
+     * Fixes a red node whose parent may be red, the ranks are recounted up
+     * front so the rotations only recount the two nodes they move
+     */
+    template<class N>
+    static N *AfterInsert(N *node) {
+        // A rotation at the root moves it down, the new root is found from it
+        N *root = N::RecountToRoot(node->parent);
+        while (IsRed(node->parent)) {
+            N *parent = node->parent;
+            N *grandparent = parent->parent;
+            if (!grandparent) {
+                parent->balance = black;
+                break;
+            }
+            if (parent == grandparent->left) {
+                N *uncle = grandparent->right;
+                if (IsRed(uncle)) {
+                    parent->balance = black;
+                    uncle->balance = black;
+                    grandparent->balance = red;
+                    node = grandparent;
+                    continue;
+                }
+                if (node == parent->right) {
+                    // Promoting the node over it's parent
+                    parent->RightRotate();
+                    parent = node;
+                }
+                parent->balance = black;
+                grandparent->balance = red;
+                grandparent->LeftRotate();
+            } else {
+                N *uncle = grandparent->left;
+                if (IsRed(uncle)) {
+                    parent->balance = black;
+                    uncle->balance = black;
+                    grandparent->balance = red;
+                    node = grandparent;
+                    continue;
+                }
+                if (node == parent->left) {
+                    parent->LeftRotate();
+                    parent = node;
+                }
+                parent->balance = black;
+                grandparent->balance = red;
+                grandparent->RightRotate();
+            }
+            break;
+        }
+        root = Top(root ? root : node);
+        root->balance = black;
+        return root;
+    }
+
+    template<class N>
+    static void BeforeRemove(N *) {}
+
+    /**
+     * Pushes the missing black of a removed black node up the tree until a
+     * red node or a rotation around a sibling absorbs it
+     */
+    template<class N>
+    static N *AfterRemove(N *child, N *parent, bool isLeftChild, int removedBalance) {
+        N *root = parent ? N::RecountToRoot(parent) : child;
+        if (!root) {
+            return nullptr;
+        }
+        if (removedBalance == black) {
+            N *node = child;
+            while (parent && !IsRed(node)) {
+                if (isLeftChild) {
+                    N *sibling = parent->right;
+                    if (IsRed(sibling)) {
+                        sibling->balance = black;
+                        parent->balance = red;
+                        parent->RightRotate();
+                        sibling = parent->right;
+                    }
+                    if (!IsRed(sibling->left) && !IsRed(sibling->right)) {
+                        sibling->balance = red;
+                        node = parent;
+                        parent = node->parent;
+                        isLeftChild = parent && parent->left == node;
+                        continue;
+                    }
+                    if (!IsRed(sibling->right)) {
+                        sibling->left->balance = black;
+                        sibling->balance = red;
+                        sibling = sibling->LeftRotate();
+                    }
+                    sibling->balance = parent->balance;
+                    parent->balance = black;
+                    sibling->right->balance = black;
+                    parent->RightRotate();
+                } else {
+                    N *sibling = parent->left;
+                    if (IsRed(sibling)) {
+                        sibling->balance = black;
+                        parent->balance = red;
+                        parent->LeftRotate();
+                        sibling = parent->left;
+                    }
+                    if (!IsRed(sibling->left) && !IsRed(sibling->right)) {
+                        sibling->balance = red;
+                        node = parent;
+                        parent = node->parent;
+                        isLeftChild = parent && parent->left == node;
+                        continue;
+                    }
+                    if (!IsRed(sibling->left)) {
+                        sibling->right->balance = black;
+                        sibling->balance = red;
+                        sibling = sibling->RightRotate();
+                    }
+                    sibling->balance = parent->balance;
+                    parent->balance = black;
+                    sibling->left->balance = black;
+                    parent->LeftRotate();
+                }
+                node = nullptr;
+                break;
+            }
+            if (node) {
+                node->balance = black;
+            }
+        }
+        root = Top(root);
+        root->balance = black;
+        return root;
+    }
+
+    /**
+     * The pivot hangs red on the spine of the tree with the greater black
+     * height at a black subtree as high as the other tree, then it is fixed
+     * like an inserted node, O(log n) with the black heights counted
+     */
+    template<class N>
+    static N *JoinWithPivot(N *left, N *pivot, N *right) {
+        // The roots of split trees may be red, blackening a root is always safe
+        if (left) {
+            left->balance = black;
+        }
+        if (right) {
+            right->balance = black;
+        }
+        int leftHeight = BlackHeight(left);
+        int rightHeight = BlackHeight(right);
+        pivot->parent = nullptr;
+        if (leftHeight > rightHeight) {
+            N *spineParent = nullptr;
+            N *spineNode = left;
+            int height = leftHeight;
+            while (IsRed(spineNode) || height > rightHeight) {
+                if (!IsRed(spineNode)) {
+                    height--;
+                }
+                spineParent = spineNode;
+                spineNode = spineNode->right;
+            }
+            pivot->left = spineNode;
+            pivot->right = right;
+            if (spineNode) {
+                spineNode->parent = pivot;
+            }
+            if (right) {
+                right->parent = pivot;
+            }
+            pivot->balance = red;
+            pivot->updateNodeRank();
+            spineParent->right = pivot;
+            pivot->parent = spineParent;
+            return AfterInsert(pivot);
+        }
+        if (rightHeight > leftHeight) {
+            N *spineParent = nullptr;
+            N *spineNode = right;
+            int height = rightHeight;
+            while (IsRed(spineNode) || height > leftHeight) {
+                if (!IsRed(spineNode)) {
+                    height--;
+                }
+                spineParent = spineNode;
+                spineNode = spineNode->left;
+            }
+            pivot->right = spineNode;
+            pivot->left = left;
+            if (spineNode) {
+                spineNode->parent = pivot;
+            }
+            if (left) {
+                left->parent = pivot;
+            }
+            pivot->balance = red;
+            pivot->updateNodeRank();
+            spineParent->left = pivot;
+            pivot->parent = spineParent;
+            return AfterInsert(pivot);
+        }
+        pivot->left = left;
+        pivot->right = right;
+        if (left) {
+            left->parent = pivot;
+        }
+        if (right) {
+            right->parent = pivot;
+        }
+        pivot->balance = black;
+        pivot->updateNodeRank();
+        return pivot;
+    }
+};
+
+/**
+ * Treap balancing, the balance field is a random priority and every node has
+ * a priority at least as high as it's children, so the shape is that of a
+ * tree built by inserting the keys in a random order, O(log n) expected
+ * The priority is a hash of the address of the node, so no random generator
+ * state is shared between trees
+ */
+struct TreapBalance {
+    template<class P>
+    static int Priority(const P &node) {
+        return node ? node->balance : -1;
+    }
+
+    template<class N>
+    static void Init(N *node) {
+        uint64_t z = (uint64_t) (uintptr_t) node + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        node->balance = (int) ((z ^ (z >> 31)) >> 33);
+    }
+
+    template<class N>
+    static void Update(N *) {}
+
+    /**
+     * A node of a tree built balanced raises it's priority to the priorities
+     * of it's children, so it gets the maximum of the random priorities under
+     * it like the root of a subtree of a random treap
+     */
+    template<class N>
+    static void InitBuilt(N *node, int, int) {
+        node->balance = std::max(node->balance, std::max(Priority(node->left), Priority(node->right)));
+    }
+
+    template<class N>
+    static N *AfterInsert(N *node) {
+        while (node->parent && node->balance > node->parent->balance) {
+            if (node->parent->left == node) {
+                node->parent->LeftRotate();
+            } else {
+                node->parent->RightRotate();
+            }
+        }
+        return N::RecountToRoot(node);
+    }
+
+    /**
+     * Rotates the node down below it's child with the higher priority until
+     * it has at most one child
+     */
+    template<class N>
+    static void BeforeRemove(N *node) {
+        while (node->left && node->right) {
+            if (node->left->balance > node->right->balance) {
+                node->LeftRotate();
+            } else {
+                node->RightRotate();
+            }
+        }
+    }
+
+    template<class N>
+    static N *AfterRemove(N *child, N *parent, bool, int) {
+        return parent ? N::RecountToRoot(parent) : child;
+    }
+
+    /**
+     * The pivot goes down between the two right and left spines until it's
+     * priority is higher than both sides, O(log n) expected
+     */
+    template<class N>
+    static N *JoinWithPivot(N *left, N *pivot, N *right) {
+        pivot->parent = nullptr;
+        if (Priority(left) <= pivot->balance && Priority(right) <= pivot->balance) {
+            pivot->left = left;
+            pivot->right = right;
+            if (left) {
+                left->parent = pivot;
+            }
+            if (right) {
+                right->parent = pivot;
+            }
+            pivot->updateNodeRank();
+            return pivot;
+        }
+        if (Priority(left) >= Priority(right)) {
+            N *spine = left->right;
+            if (spine) {
+                spine->parent = nullptr;
+            }
+            left->right = JoinWithPivot(spine, pivot, right);
+            left->right->parent = left;
+            left->updateNodeRank();
+            return left;
+        }
+        N *spine = right->left;
+        if (spine) {
+            spine->parent = nullptr;
+        }
+        right->left = JoinWithPivot(left, pivot, spine);
+        right->left->parent = right;
+        right->updateNodeRank();
+        return right;
+    }
+};
+
+#endif //WET2_BALANCEPOLICY_H
@@ -0,0 +1,1717 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_COUNTEDBPLUSTREE_H
+#define WET2_COUNTEDBPLUSTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include "NodeStorage.h"
+
+/**
+ * Every node other than the root holds between rankedNodeMinimum and
+ * rankedNodeCapacity entries, keys in a leaf or children in an inner node
+ * With at least rankedNodeMinimum children per inner node rankedMaxDepth
+ * levels are enough for any int number of keys
+ */
+const int rankedNodeCapacity = 32;
+const int rankedNodeMinimum = rankedNodeCapacity / 2;
+const int rankedMaxDepth = 16;
+
+/**
+ * A batch of changes with at least one key per rankedRebuildFactor keys in the
+ * tree rebuilds the tree from it's sorted keys instead of changing them one
+ * by one
+ */
+const int rankedRebuildFactor = 16;
+
+template<class K, class T, bool isReverse, class S>
+class CountedBPlusTreeIterator;
+
+/**
+ * The data pointers of a CountedBPlusTree leaf, a tree with void data holds
+ * only it's keys so the tree is a set and it's leaves have no data array
+ * @tparam T Type of the stored data
+ */
+template<class T, class S>
+struct CountedBPlusTreeLeafData {
+    T *data[rankedNodeCapacity];
+
+    T *getStoredData(int position) const {
+        return data[position];
+    }
+
+    void setStoredData(int position, T *nData) {
+        data[position] = nData;
+    }
+
+    void deleteStoredData(int position) {
+        delete data[position];
+    }
+
+    static void DeleteData(T *data) {
+        delete data;
+    }
+
+    void relocateStoredData(int position) {
+        data[position] = RelocateData<S>(data[position]);
+    }
+
+    /**
+     * Copies data pointers from a range of a leaf, which may overlap the
+     * range they are copied to
+     */
+    void moveStoredData(int position, const CountedBPlusTreeLeafData<T, S> &from, int fromPosition, int count) {
+        memmove(data + position, from.data + fromPosition, sizeof(T *) * count);
+    }
+
+    void copyStoredDataTo(int position, T **array, int count) const {
+        memcpy(array, data + position, sizeof(T *) * count);
+    }
+
+    void copyStoredDataFrom(int position, T *const *array, int count) {
+        memcpy(data + position, array, sizeof(T *) * count);
+    }
+};
+
+template<class S>
+struct CountedBPlusTreeLeafData<void, S> {
+    void *getStoredData(int) const {
+        return nullptr;
+    }
+
+    void setStoredData(int, void *) {}
+
+    void deleteStoredData(int) {}
+
+    static void DeleteData(void *) {}
+
+    void relocateStoredData(int) {}
+
+    void moveStoredData(int, const CountedBPlusTreeLeafData<void, S> &, int, int) {}
+
+    void copyStoredDataTo(int, void **, int) const {}
+
+    void copyStoredDataFrom(int, void *const *, int) {}
+};
+
+/**
+ * Generic Template Class for an order statistic B+tree
+ * The keys and their data are stored sorted in the leaves, every inner node
+ * keeps the smallest key and the number of keys under each of it's children,
+ * so a search by key or by rank reads one wide node per level
+ * Offers the same ranking interface as RankTree, where rank 1 is the maximal
+ * key, and owns the data it stores the same way, with void data the tree is
+ * a set of keys
+ * Insertions and removals record their path from the root and fix the counts,
+ * splits and merges on the way back up
+ * @tparam K Class for node key comparisons, must be default constructible
+ * @tparam T Type of the stored data, deleted when it's key is removed
+ */
+template<class K, class T, class S = PointerStorage>
+class CountedBPlusTree {
+private:
+    struct Node {
+        bool isLeaf;
+        int size;
+
+        explicit Node(bool isLeaf) : isLeaf(isLeaf), size(0) {}
+    };
+
+    struct Leaf : Node, CountedBPlusTreeLeafData<T, S>, S::template NodeBase<Leaf> {
+        K keys[rankedNodeCapacity];
+
+        Leaf() : Node(true) {}
+    };
+
+    /**
+     * separators[i] is the smallest key routed to children[i], separators[0]
+     * is only meaningful while the node is being split
+     */
+    struct Inner : Node, S::template NodeBase<Inner> {
+        K separators[rankedNodeCapacity];
+        int counts[rankedNodeCapacity];
+        Node *children[rankedNodeCapacity];
+
+        Inner() : Node(false) {}
+    };
+
+public:
+    /**
+     * The pools of the leaves and of the inner nodes, which are allocated
+     * separately since they differ in size
+     */
+    struct NodePool {
+        typename S::template Pool<Leaf> leaves;
+        typename S::template Pool<Inner> inners;
+
+        void BeginRelocation() {
+            leaves.BeginRelocation();
+            inners.BeginRelocation();
+        }
+
+        void EndRelocation() {
+            leaves.EndRelocation();
+            inners.EndRelocation();
+        }
+
+        void Clear() {
+            leaves.Clear();
+            inners.Clear();
+        }
+    };
+
+private:
+    Node *root = nullptr;
+    int numberOfItems = 0;
+    NodePool *pool;
+
+    static typename S::template Pool<Leaf> *LeafPool(NodePool *pool);
+
+    static typename S::template Pool<Inner> *InnerPool(NodePool *pool);
+
+    static int LeafLowerBound(Leaf *leaf, const K &key);
+
+    static int ChildPosition(Inner *inner, const K &key);
+
+    static int SubtreeCount(Node *node);
+
+    static void InsertChild(Inner *inner, int position, const K &separator, Node *child, int count);
+
+    static void RemoveChild(Inner *inner, int position);
+
+    static void MergeChildren(Inner *parent, int position);
+
+    static void FillChild(Inner *parent, int position);
+
+    static Inner *InsertChildOnPath(Inner **path, const int *positions, int depth, Inner *inner, int position,
+                                    const K &separator, Node *child, int count);
+
+    static bool BalanceNodes(Node *left, Node *right, K &separator);
+
+    static int Height(Node *node);
+
+    static Node *JoinNodes(Node *left, int leftHeight, Node *right, int rightHeight, const K &separator,
+                           int &height, NodePool *pool);
+
+    static void DeleteNodes(Node *node, bool isDeletingData = true);
+
+    static void FillArrWithEntriesInOrder(Node *node, K *&keys, T **&data);
+
+    static Node *BuildFromSorted(const K *keys, T **data, int size, NodePool *pool);
+
+    static bool RelocateSubtree(Node *&node, RelocationCursor<K> &cursor, int &budget);
+
+    template<class, class, bool, class> friend class CountedBPlusTreeIterator;
+
+public:
+    typedef CountedBPlusTreeIterator<K, T, false, S> Iterator;
+    typedef CountedBPlusTreeIterator<K, T, true, S> ReverseIterator;
+
+    explicit CountedBPlusTree(NodePool *pool = nullptr);
+
+    CountedBPlusTree(const CountedBPlusTree<K, T, S> &other) = delete;
+
+    CountedBPlusTree(CountedBPlusTree<K, T, S> &&other) noexcept;
+
+    CountedBPlusTree<K, T, S> &operator=(const CountedBPlusTree<K, T, S> &other) = delete;
+
+    CountedBPlusTree<K, T, S> &operator=(CountedBPlusTree<K, T, S> &&other) noexcept;
+
+    void Insert(const K &key, T *data = nullptr);
+
+    void Remove(const K &key);
+
+    void ReplaceKeys(const K *removedKeys, int numberOfRemoved, const K *insertedKeys, int numberOfInserted);
+
+    void InsertBatch(const K *keys, int numberOfKeys);
+
+    CountedBPlusTree<K, T, S> Split(const K &key);
+
+    static CountedBPlusTree<K, T, S> Join(CountedBPlusTree<K, T, S> &left, CountedBPlusTree<K, T, S> &right);
+
+    CountedBPlusTree<K, T, S> ExtractRange(const K &from, const K &to);
+
+    void RemoveRange(const K &from, const K &to);
+
+    bool RelocateNodes(RelocationCursor<K> &cursor, int &budget);
+
+    void MarkRootAsNullptr();
+
+    K FindByRank(int searchRank);
+
+    bool IsRootNull();
+
+    int getSize();
+
+    Iterator begin();
+
+    Iterator end();
+
+    ReverseIterator rbegin();
+
+    ReverseIterator rend();
+
+    Iterator IteratorFrom(const K &key);
+
+    ReverseIterator ReverseIteratorFrom(const K &key);
+
+    Iterator IteratorAtRank(int rank);
+
+    ReverseIterator ReverseIteratorAtRank(int rank);
+
+    ~CountedBPlusTree();
+};
+
+/**
+ * Generic Template Class for an in order iterator over a CountedBPlusTree
+ * Keeps the path from the root to the current leaf in fixed arrays, so an
+ * iterator is never allocated, and moving to the next leaf climbs only as far
+ * as the first ancestor with another child, which makes a full scan O(n)
+ * The end of the scan has no leaf
+ * @tparam K Class for node key comparisons
+ * @tparam T Type of the stored data
+ * @tparam isReverse True to scan from the maximal key down, which is the
+ * order of increasing rank
+ */
+template<class K, class T, bool isReverse, class S>
+class CountedBPlusTreeIterator {
+private:
+    typedef typename CountedBPlusTree<K, T, S>::Node Node;
+    typedef typename CountedBPlusTree<K, T, S>::Inner Inner;
+    typedef typename CountedBPlusTree<K, T, S>::Leaf Leaf;
+
+    Inner *path[rankedMaxDepth];
+    int positions[rankedMaxDepth];
+    int depth = 0;
+    Leaf *leaf = nullptr;
+    int index = 0;
+
+    void DescendToEdge(Node *node);
+
+    void DescendToKey(Node *root, const K &key);
+
+    void DescendToIndex(Node *root, int keyIndex);
+
+    void MoveToNextLeaf();
+
+    friend class CountedBPlusTree<K, T, S>;
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef K value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const K *pointer;
+    typedef const K &reference;
+
+    CountedBPlusTreeIterator() = default;
+
+    const K &operator*() const;
+
+    const K *operator->() const;
+
+    T *getData() const;
+
+    CountedBPlusTreeIterator<K, T, isReverse, S> &operator++();
+
+    CountedBPlusTreeIterator<K, T, isReverse, S> operator++(int);
+
+    bool operator==(const CountedBPlusTreeIterator<K, T, isReverse, S> &other) const;
+
+    bool operator!=(const CountedBPlusTreeIterator<K, T, isReverse, S> &other) const;
+};
+
+/**
+ * Creates an empty tree
+ * @param pool The pools to allocate the nodes from
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S>::CountedBPlusTree(NodePool *pool): pool(pool) {}
+
+/**
+ * Takes ownership of the nodes of another tree, leaving the other tree empty
+ * @param other The tree to move the nodes from
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S>::CountedBPlusTree(CountedBPlusTree<K, T, S> &&other) noexcept:
+        root(other.root), numberOfItems(other.numberOfItems), pool(other.pool) {
+    other.root = nullptr;
+    other.numberOfItems = 0;
+}
+
+/**
+ * Deletes the nodes of this tree and takes ownership of the nodes of another
+ * tree, leaving the other tree empty
+ * @param other The tree to move the nodes from
+ * @return A reference to this tree
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S> &CountedBPlusTree<K, T, S>::operator=(CountedBPlusTree<K, T, S> &&other) noexcept {
+    if (this != &other) {
+        DeleteNodes(root);
+        root = other.root;
+        numberOfItems = other.numberOfItems;
+        pool = other.pool;
+        other.root = nullptr;
+        other.numberOfItems = 0;
+    }
+    return *this;
+}
+
+/**
+ * @param pool The pools of a tree, may be nullptr when the policy needs none
+ * @return The pool of the leaves
+ */
+template<class K, class T, class S>
+typename S::template Pool<typename CountedBPlusTree<K, T, S>::Leaf> *
+CountedBPlusTree<K, T, S>::LeafPool(NodePool *pool) {
+    return pool ? &pool->leaves : nullptr;
+}
+
+/**
+ * @param pool The pools of a tree, may be nullptr when the policy needs none
+ * @return The pool of the inner nodes
+ */
+template<class K, class T, class S>
+typename S::template Pool<typename CountedBPlusTree<K, T, S>::Inner> *
+CountedBPlusTree<K, T, S>::InnerPool(NodePool *pool) {
+    return pool ? &pool->inners : nullptr;
+}
+
+/**
+ * Finds the position of the first key in the leaf that is not smaller than
+ * the input key
+ * @param leaf The leaf to search in
+ * @param key The key to search for
+ * @return The position of the key if it exists, or where it would be inserted
+ */
+template<class K, class T, class S>
+int CountedBPlusTree<K, T, S>::LeafLowerBound(Leaf *leaf, const K &key) {
+    int low = 0;
+    int high = leaf->size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (leaf->keys[middle] < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Finds the child of the inner node whose subtree holds the input key
+ * @param inner The node to search in
+ * @param key The key to search for
+ * @return The position of the child to descend to
+ */
+template<class K, class T, class S>
+int CountedBPlusTree<K, T, S>::ChildPosition(Inner *inner, const K &key) {
+    int low = 1;
+    int high = inner->size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (key < inner->separators[middle]) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low - 1;
+}
+
+/**
+ * Returns the number of keys stored under the input node
+ */
+template<class K, class T, class S>
+int CountedBPlusTree<K, T, S>::SubtreeCount(Node *node) {
+    if (node->isLeaf) {
+        return node->size;
+    }
+    Inner *inner = static_cast<Inner *>(node);
+    int count = 0;
+    for (int i = 0; i < inner->size; ++i) {
+        count += inner->counts[i];
+    }
+    return count;
+}
+
+/**
+ * Inserts a child into an inner node that is not full
+ * @param inner The node to insert the child to
+ * @param position The position of the new child
+ * @param separator The smallest key under the new child
+ * @param child The new child
+ * @param count The number of keys under the new child
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::InsertChild(Inner *inner, int position, const K &separator, Node *child, int count) {
+    for (int i = inner->size; i > position; --i) {
+        inner->separators[i] = inner->separators[i - 1];
+    }
+    memmove(inner->counts + position + 1, inner->counts + position, sizeof(int) * (inner->size - position));
+    memmove(inner->children + position + 1, inner->children + position, sizeof(Node *) * (inner->size - position));
+    inner->separators[position] = separator;
+    inner->counts[position] = count;
+    inner->children[position] = child;
+    inner->size++;
+}
+
+/**
+ * Removes a child from an inner node without deleting it
+ * @param inner The node to remove the child from
+ * @param position The position of the child
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::RemoveChild(Inner *inner, int position) {
+    for (int i = position; i < inner->size - 1; ++i) {
+        inner->separators[i] = inner->separators[i + 1];
+    }
+    memmove(inner->counts + position, inner->counts + position + 1, sizeof(int) * (inner->size - position - 1));
+    memmove(inner->children + position, inner->children + position + 1, sizeof(Node *) * (inner->size - position - 1));
+    inner->size--;
+}
+
+/**
+ * Moves all the entries of a child into it's left sibling and deletes it
+ * @param parent The parent of the two children
+ * @param position The position of the left child
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::MergeChildren(Inner *parent, int position) {
+    Node *left = parent->children[position];
+    Node *right = parent->children[position + 1];
+    if (left->isLeaf) {
+        Leaf *leftLeaf = static_cast<Leaf *>(left);
+        Leaf *rightLeaf = static_cast<Leaf *>(right);
+        for (int i = 0; i < rightLeaf->size; ++i) {
+            leftLeaf->keys[leftLeaf->size + i] = rightLeaf->keys[i];
+        }
+        leftLeaf->moveStoredData(leftLeaf->size, *rightLeaf, 0, rightLeaf->size);
+    } else {
+        Inner *leftInner = static_cast<Inner *>(left);
+        Inner *rightInner = static_cast<Inner *>(right);
+        leftInner->separators[leftInner->size] = parent->separators[position + 1];
+        for (int i = 1; i < rightInner->size; ++i) {
+            leftInner->separators[leftInner->size + i] = rightInner->separators[i];
+        }
+        memcpy(leftInner->counts + leftInner->size, rightInner->counts, sizeof(int) * rightInner->size);
+        memcpy(leftInner->children + leftInner->size, rightInner->children, sizeof(Node *) * rightInner->size);
+    }
+    left->size += right->size;
+    if (right->isLeaf) {
+        delete static_cast<Leaf *>(right);
+    } else {
+        delete static_cast<Inner *>(right);
+    }
+    parent->counts[position] += parent->counts[position + 1];
+    RemoveChild(parent, position + 1);
+}
+
+/**
+ * Brings a child that dropped under rankedNodeMinimum entries back to the
+ * minimum, by moving one entry from a sibling or merging with it
+ * @param parent The parent of the child
+ * @param position The position of the child
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::FillChild(Inner *parent, int position) {
+    Node *child = parent->children[position];
+    if (position > 0 && parent->children[position - 1]->size > rankedNodeMinimum) {
+        // Moving the last entry of the left sibling to the front of the child
+        Node *sibling = parent->children[position - 1];
+        int moved;
+        if (child->isLeaf) {
+            Leaf *leaf = static_cast<Leaf *>(child);
+            Leaf *from = static_cast<Leaf *>(sibling);
+            for (int i = leaf->size; i > 0; --i) {
+                leaf->keys[i] = leaf->keys[i - 1];
+            }
+            leaf->moveStoredData(1, *leaf, 0, leaf->size);
+            leaf->keys[0] = from->keys[from->size - 1];
+            leaf->setStoredData(0, from->getStoredData(from->size - 1));
+            leaf->size++;
+            parent->separators[position] = leaf->keys[0];
+            moved = 1;
+        } else {
+            Inner *inner = static_cast<Inner *>(child);
+            Inner *from = static_cast<Inner *>(sibling);
+            InsertChild(inner, 0, from->separators[from->size - 1], from->children[from->size - 1],
+                        from->counts[from->size - 1]);
+            inner->separators[1] = parent->separators[position];
+            parent->separators[position] = inner->separators[0];
+            moved = inner->counts[0];
+        }
+        sibling->size--;
+        parent->counts[position - 1] -= moved;
+        parent->counts[position] += moved;
+    } else if (position < parent->size - 1 && parent->children[position + 1]->size > rankedNodeMinimum) {
+        // Moving the first entry of the right sibling to the end of the child
+        Node *sibling = parent->children[position + 1];
+        int moved;
+        if (child->isLeaf) {
+            Leaf *leaf = static_cast<Leaf *>(child);
+            Leaf *from = static_cast<Leaf *>(sibling);
+            leaf->keys[leaf->size] = from->keys[0];
+            leaf->setStoredData(leaf->size, from->getStoredData(0));
+            for (int i = 0; i < from->size - 1; ++i) {
+                from->keys[i] = from->keys[i + 1];
+            }
+            from->moveStoredData(0, *from, 1, from->size - 1);
+            parent->separators[position + 1] = from->keys[0];
+            moved = 1;
+            leaf->size++;
+            from->size--;
+        } else {
+            Inner *inner = static_cast<Inner *>(child);
+            Inner *from = static_cast<Inner *>(sibling);
+            moved = from->counts[0];
+            inner->separators[inner->size] = parent->separators[position + 1];
+            inner->counts[inner->size] = moved;
+            inner->children[inner->size] = from->children[0];
+            inner->size++;
+            parent->separators[position + 1] = from->separators[1];
+            RemoveChild(from, 0);
+        }
+        parent->counts[position] += moved;
+        parent->counts[position + 1] -= moved;
+    } else if (position > 0) {
+        MergeChildren(parent, position - 1);
+    } else {
+        MergeChildren(parent, position);
+    }
+}
+
+/**
+ * Inserts a child into an inner node on a recorded path, a full node is split
+ * and it's new sibling is inserted into the node above it the same way
+ * The counts along the path must already include the keys under the child
+ * @param path The inner nodes above the input node, from the root down
+ * @param positions The position of every path node's child on the path
+ * @param depth The number of nodes above the input node
+ * @param inner The node to insert the child to
+ * @param position The position of the new child
+ * @param separator The separator of the new child
+ * @param child The new child
+ * @param count The number of keys under the new child
+ * @return A new root if the root was split, nullptr otherwise
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Inner *
+CountedBPlusTree<K, T, S>::InsertChildOnPath(Inner **path, const int *positions, int depth, Inner *inner, int position,
+                                          const K &separator, Node *child, int count) {
+    K splitKey = separator;
+    Node *split = child;
+    int splitCount = count;
+    while (inner->size == rankedNodeCapacity) {
+        // Splitting the full node, the upper half moves to a new sibling
+        Inner *sibling = new (S::PoolOf(inner)) Inner();
+        for (int i = rankedNodeMinimum; i < rankedNodeCapacity; ++i) {
+            sibling->separators[i - rankedNodeMinimum] = inner->separators[i];
+        }
+        memcpy(sibling->counts, inner->counts + rankedNodeMinimum, sizeof(int) * (rankedNodeCapacity - rankedNodeMinimum));
+        memcpy(sibling->children, inner->children + rankedNodeMinimum,
+               sizeof(Node *) * (rankedNodeCapacity - rankedNodeMinimum));
+        sibling->size = rankedNodeCapacity - rankedNodeMinimum;
+        inner->size = rankedNodeMinimum;
+        if (position > rankedNodeMinimum) {
+            InsertChild(sibling, position - rankedNodeMinimum, splitKey, split, splitCount);
+        } else {
+            InsertChild(inner, position, splitKey, split, splitCount);
+        }
+        split = sibling;
+        splitKey = sibling->separators[0];
+        splitCount = SubtreeCount(sibling);
+        if (depth == 0) {
+            // The root was split, the tree grows in height
+            Inner *newRoot = new (S::PoolOf(inner)) Inner();
+            newRoot->children[0] = inner;
+            newRoot->counts[0] = SubtreeCount(inner);
+            newRoot->size = 1;
+            InsertChild(newRoot, 1, splitKey, split, splitCount);
+            return newRoot;
+        }
+        Inner *parent = path[--depth];
+        position = positions[depth];
+        parent->counts[position] -= splitCount;
+        inner = parent;
+        position++;
+    }
+    InsertChild(inner, position, splitKey, split, splitCount);
+    return nullptr;
+}
+
+/**
+ * Evens out two neighbouring nodes of the same height, every entry moves to
+ * the left node if they fit in one node, otherwise entries move between them
+ * until both hold at least rankedNodeMinimum entries
+ * Used by joins, where the root of one tree can hold any number of entries
+ * @param left The left node
+ * @param right The right node, deleted if it's entries moved to the left node
+ * @param separator A key greater than the keys of the left node and not
+ * greater than the keys of the right node, set to the new boundary
+ * @return True if the nodes were merged into the left node
+ */
+template<class K, class T, class S>
+bool CountedBPlusTree<K, T, S>::BalanceNodes(Node *left, Node *right, K &separator) {
+    int total = left->size + right->size;
+    int leftSize = (total <= rankedNodeCapacity) ? total : total / 2;
+    if (left->isLeaf) {
+        Leaf *leftLeaf = static_cast<Leaf *>(left);
+        Leaf *rightLeaf = static_cast<Leaf *>(right);
+        if (leftLeaf->size < leftSize) {
+            int moved = leftSize - leftLeaf->size;
+            for (int i = 0; i < moved; ++i) {
+                leftLeaf->keys[leftLeaf->size + i] = rightLeaf->keys[i];
+            }
+            leftLeaf->moveStoredData(leftLeaf->size, *rightLeaf, 0, moved);
+            for (int i = moved; i < rightLeaf->size; ++i) {
+                rightLeaf->keys[i - moved] = rightLeaf->keys[i];
+            }
+            rightLeaf->moveStoredData(0, *rightLeaf, moved, rightLeaf->size - moved);
+        } else if (leftLeaf->size > leftSize) {
+            int moved = leftLeaf->size - leftSize;
+            for (int i = rightLeaf->size - 1; i >= 0; --i) {
+                rightLeaf->keys[i + moved] = rightLeaf->keys[i];
+            }
+            rightLeaf->moveStoredData(moved, *rightLeaf, 0, rightLeaf->size);
+            for (int i = 0; i < moved; ++i) {
+                rightLeaf->keys[i] = leftLeaf->keys[leftSize + i];
+            }
+            rightLeaf->moveStoredData(0, *leftLeaf, leftSize, moved);
+        }
+        rightLeaf->size = total - leftSize;
+        leftLeaf->size = leftSize;
+        if (rightLeaf->size == 0) {
+            delete rightLeaf;
+            return true;
+        }
+        separator = rightLeaf->keys[0];
+        return false;
+    }
+    Inner *leftInner = static_cast<Inner *>(left);
+    Inner *rightInner = static_cast<Inner *>(right);
+    if (leftInner->size < leftSize) {
+        // The first child of the right node is routed by the old boundary
+        int moved = leftSize - leftInner->size;
+        leftInner->separators[leftInner->size] = separator;
+        for (int i = 1; i < moved; ++i) {
+            leftInner->separators[leftInner->size + i] = rightInner->separators[i];
+        }
+        memcpy(leftInner->counts + leftInner->size, rightInner->counts, sizeof(int) * moved);
+        memcpy(leftInner->children + leftInner->size, rightInner->children, sizeof(Node *) * moved);
+        if (moved < rightInner->size) {
+            separator = rightInner->separators[moved];
+        }
+        for (int i = moved; i < rightInner->size; ++i) {
+            rightInner->separators[i - moved] = rightInner->separators[i];
+        }
+        memmove(rightInner->counts, rightInner->counts + moved, sizeof(int) * (rightInner->size - moved));
+        memmove(rightInner->children, rightInner->children + moved, sizeof(Node *) * (rightInner->size - moved));
+    } else if (leftInner->size > leftSize) {
+        int moved = leftInner->size - leftSize;
+        for (int i = rightInner->size - 1; i >= 0; --i) {
+            rightInner->separators[i + moved] = rightInner->separators[i];
+        }
+        memmove(rightInner->counts + moved, rightInner->counts, sizeof(int) * rightInner->size);
+        memmove(rightInner->children + moved, rightInner->children, sizeof(Node *) * rightInner->size);
+        rightInner->separators[moved] = separator;
+        for (int i = 0; i < moved; ++i) {
+            rightInner->separators[i] = leftInner->separators[leftSize + i];
+        }
+        memcpy(rightInner->counts, leftInner->counts + leftSize, sizeof(int) * moved);
+        memcpy(rightInner->children, leftInner->children + leftSize, sizeof(Node *) * moved);
+        separator = rightInner->separators[0];
+    }
+    rightInner->size = total - leftSize;
+    leftInner->size = leftSize;
+    if (rightInner->size == 0) {
+        delete rightInner;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the number of levels of the subtree of the input node, 0 for nullptr
+ */
+template<class K, class T, class S>
+int CountedBPlusTree<K, T, S>::Height(Node *node) {
+    int height = 0;
+    while (node) {
+        height++;
+        node = node->isLeaf ? nullptr : static_cast<Inner *>(node)->children[0];
+    }
+    return height;
+}
+
+/**
+ * Joins two subtrees into one, every key of the left subtree must be smaller
+ * than every key of the right subtree
+ * The shorter subtree becomes a child on the edge of the taller one, next to
+ * a node of the same height that it's evened out with, so the join costs
+ * O(difference of heights + 1)
+ * The roots of the subtrees may hold any number of entries, every other node
+ * must hold at least rankedNodeMinimum, and so does every node other than the
+ * root of the result
+ * @param left The root of the left subtree, may be nullptr
+ * @param leftHeight The height of the left subtree
+ * @param right The root of the right subtree, may be nullptr
+ * @param rightHeight The height of the right subtree
+ * @param separator A key greater than the keys of the left subtree and not
+ * greater than the keys of the right subtree
+ * @param height Set to the height of the joined subtree
+ * @param pool The pools to allocate a new root from
+ * @return The root of the joined subtree
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Node *
+CountedBPlusTree<K, T, S>::JoinNodes(Node *left, int leftHeight, Node *right, int rightHeight, const K &separator,
+                                  int &height, NodePool *pool) {
+    if (!left || !right) {
+        height = left ? leftHeight : rightHeight;
+        return left ? left : right;
+    }
+    K boundary = separator;
+    if (leftHeight == rightHeight) {
+        if (BalanceNodes(left, right, boundary)) {
+            height = leftHeight;
+            return left;
+        }
+        Inner *newRoot = new (InnerPool(pool)) Inner();
+        newRoot->children[0] = left;
+        newRoot->counts[0] = SubtreeCount(left);
+        newRoot->size = 1;
+        InsertChild(newRoot, 1, boundary, right, SubtreeCount(right));
+        height = leftHeight + 1;
+        return newRoot;
+    }
+    Inner *path[rankedMaxDepth];
+    int positions[rankedMaxDepth];
+    int depth = 0;
+    if (leftHeight > rightHeight) {
+        // Walking down the last children of the left subtree to the level
+        // above the right subtree
+        int added = SubtreeCount(right);
+        Inner *inner = static_cast<Inner *>(left);
+        for (int level = leftHeight; level > rightHeight + 1; --level) {
+            path[depth] = inner;
+            positions[depth++] = inner->size - 1;
+            inner->counts[inner->size - 1] += added;
+            inner = static_cast<Inner *>(inner->children[inner->size - 1]);
+        }
+        int last = inner->size - 1;
+        inner->counts[last] += added;
+        height = leftHeight;
+        if (BalanceNodes(inner->children[last], right, boundary)) {
+            return left;
+        }
+        inner->counts[last] = SubtreeCount(inner->children[last]);
+        Inner *newRoot = InsertChildOnPath(path, positions, depth, inner, last + 1, boundary, right,
+                                           SubtreeCount(right));
+        if (newRoot) {
+            height++;
+            return newRoot;
+        }
+        return left;
+    }
+    // Walking down the first children of the right subtree to the level above
+    // the left subtree
+    int added = SubtreeCount(left);
+    Inner *inner = static_cast<Inner *>(right);
+    for (int level = rightHeight; level > leftHeight + 1; --level) {
+        path[depth] = inner;
+        positions[depth++] = 0;
+        inner->counts[0] += added;
+        inner = static_cast<Inner *>(inner->children[0]);
+    }
+    inner->counts[0] += added;
+    height = rightHeight;
+    if (BalanceNodes(left, inner->children[0], boundary)) {
+        inner->children[0] = left;
+        return right;
+    }
+    inner->counts[0] = SubtreeCount(inner->children[0]);
+    // The separator of the old first child moves with it to position 1
+    inner->separators[0] = boundary;
+    Inner *newRoot = InsertChildOnPath(path, positions, depth, inner, 0, boundary, left, SubtreeCount(left));
+    if (newRoot) {
+        height++;
+        return newRoot;
+    }
+    return right;
+}
+
+/**
+ * Deletes the subtree of the input node
+ * @param node The root of the subtree
+ * @param isDeletingData False if the data of the keys was handed elsewhere
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::DeleteNodes(Node *node, bool isDeletingData) {
+    if (!node) {
+        return;
+    }
+    if (node->isLeaf) {
+        Leaf *leaf = static_cast<Leaf *>(node);
+        for (int i = 0; isDeletingData && i < leaf->size; ++i) {
+            leaf->deleteStoredData(i);
+        }
+        delete leaf;
+    } else {
+        Inner *inner = static_cast<Inner *>(node);
+        for (int i = 0; i < inner->size; ++i) {
+            DeleteNodes(inner->children[i], isDeletingData);
+        }
+        delete inner;
+    }
+}
+
+/**
+ * Fills arrays with the keys and data of the subtree in ascending order
+ * @param node The root of the subtree
+ * @param keys The next key cell to fill, moved past the filled cells
+ * @param data The next data cell to fill, moved past the filled cells
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::FillArrWithEntriesInOrder(Node *node, K *&keys, T **&data) {
+    if (node->isLeaf) {
+        Leaf *leaf = static_cast<Leaf *>(node);
+        for (int i = 0; i < leaf->size; ++i) {
+            *keys++ = leaf->keys[i];
+        }
+        leaf->copyStoredDataTo(0, data, leaf->size);
+        data += leaf->size;
+        return;
+    }
+    Inner *inner = static_cast<Inner *>(node);
+    for (int i = 0; i < inner->size; ++i) {
+        FillArrWithEntriesInOrder(inner->children[i], keys, data);
+    }
+}
+
+/**
+ * Builds a tree from sorted keys one level at a time, from the leaves up
+ * Every level spreads it's entries evenly over the fewest nodes that can hold
+ * them, which keeps every node other than the root at least half full
+ * @param keys The keys of the tree, sorted and without duplicates
+ * @param data The data of every key
+ * @param size The number of keys
+ * @param pool The pools to allocate the nodes from
+ * @return The root of the new tree, nullptr if there are no keys
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Node *CountedBPlusTree<K, T, S>::BuildFromSorted(const K *keys, T **data, int size,
+                                                                                     NodePool *pool) {
+    if (size <= 0) {
+        return nullptr;
+    }
+    int numberOfNodes = (size + rankedNodeCapacity - 1) / rankedNodeCapacity;
+    Node **level = new Node *[numberOfNodes];
+    K *minimums = new K[numberOfNodes];
+    int *counts = new int[numberOfNodes];
+    int position = 0;
+    for (int i = 0; i < numberOfNodes; ++i) {
+        Leaf *leaf = new (LeafPool(pool)) Leaf();
+        leaf->size = size / numberOfNodes + (i < size % numberOfNodes ? 1 : 0);
+        for (int j = 0; j < leaf->size; ++j) {
+            leaf->keys[j] = keys[position + j];
+        }
+        leaf->copyStoredDataFrom(0, data + position, leaf->size);
+        position += leaf->size;
+        level[i] = leaf;
+        minimums[i] = leaf->keys[0];
+        counts[i] = leaf->size;
+    }
+    while (numberOfNodes > 1) {
+        int numberOfParents = (numberOfNodes + rankedNodeCapacity - 1) / rankedNodeCapacity;
+        int child = 0;
+        for (int i = 0; i < numberOfParents; ++i) {
+            Inner *inner = new (InnerPool(pool)) Inner();
+            inner->size = numberOfNodes / numberOfParents + (i < numberOfNodes % numberOfParents ? 1 : 0);
+            int count = 0;
+            for (int j = 0; j < inner->size; ++j) {
+                inner->separators[j] = minimums[child];
+                inner->counts[j] = counts[child];
+                inner->children[j] = level[child];
+                count += counts[child];
+                child++;
+            }
+            // Every parent takes at least one child, so the parents never
+            // overwrite a child that wasn't taken yet
+            level[i] = inner;
+            minimums[i] = inner->separators[0];
+            counts[i] = count;
+        }
+        numberOfNodes = numberOfParents;
+    }
+    Node *newRoot = level[0];
+    delete[] level;
+    delete[] minimums;
+    delete[] counts;
+    return newRoot;
+}
+
+/**
+ * Inserts a new key with the given data to the tree
+ * If the key already exists in the tree, nothing will be done
+ * (This also means the dynamic data sent to the function will not
+ * be freed)
+ * @param key The key to insert
+ * @param data The data of the key
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::Insert(const K &key, T *data) {
+    if (!root) {
+        root = new (LeafPool(pool)) Leaf();
+    }
+    Inner *path[rankedMaxDepth];
+    int positions[rankedMaxDepth];
+    int depth = 0;
+    Node *node = root;
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = ChildPosition(inner, key);
+        path[depth] = inner;
+        positions[depth++] = position;
+        node = inner->children[position];
+    }
+    Leaf *leaf = static_cast<Leaf *>(node);
+    int position = LeafLowerBound(leaf, key);
+    if (position < leaf->size && !(key < leaf->keys[position])) {
+        // The input key already exists in the tree
+        return;
+    }
+    if (leaf->size == rankedNodeCapacity) {
+        // Splitting the full leaf, the upper half moves to a new sibling
+        Leaf *sibling = new (S::PoolOf(leaf)) Leaf();
+        for (int i = rankedNodeMinimum; i < rankedNodeCapacity; ++i) {
+            sibling->keys[i - rankedNodeMinimum] = leaf->keys[i];
+        }
+        sibling->moveStoredData(0, *leaf, rankedNodeMinimum, rankedNodeCapacity - rankedNodeMinimum);
+        sibling->size = rankedNodeCapacity - rankedNodeMinimum;
+        leaf->size = rankedNodeMinimum;
+        node = sibling;
+        if (position > rankedNodeMinimum) {
+            leaf = sibling;
+            position -= rankedNodeMinimum;
+        }
+    } else {
+        node = nullptr;
+    }
+    for (int i = leaf->size; i > position; --i) {
+        leaf->keys[i] = leaf->keys[i - 1];
+    }
+    leaf->moveStoredData(position + 1, *leaf, position, leaf->size - position);
+    leaf->keys[position] = key;
+    leaf->setStoredData(position, data);
+    leaf->size++;
+    numberOfItems++;
+
+    for (int i = 0; i < depth; ++i) {
+        path[i]->counts[positions[i]]++;
+    }
+    if (!node) {
+        return;
+    }
+    // node holds the new sibling of the split leaf
+    int splitCount = node->size;
+    if (depth == 0) {
+        // The root was split, the tree grows in height
+        Inner *newRoot = new (InnerPool(pool)) Inner();
+        newRoot->children[0] = root;
+        newRoot->counts[0] = root->size;
+        newRoot->size = 1;
+        InsertChild(newRoot, 1, static_cast<Leaf *>(node)->keys[0], node, splitCount);
+        root = newRoot;
+        return;
+    }
+    Inner *parent = path[--depth];
+    parent->counts[positions[depth]] -= splitCount;
+    Inner *newRoot = InsertChildOnPath(path, positions, depth, parent, positions[depth] + 1,
+                                       static_cast<Leaf *>(node)->keys[0], node, splitCount);
+    if (newRoot) {
+        root = newRoot;
+    }
+}
+
+/**
+ * Removes a key from the tree and deletes it's data
+ * @param key The key to remove
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::Remove(const K &key) {
+    if (!root) {
+        return;
+    }
+    Inner *path[rankedMaxDepth];
+    int positions[rankedMaxDepth];
+    int depth = 0;
+    Node *node = root;
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = ChildPosition(inner, key);
+        path[depth] = inner;
+        positions[depth++] = position;
+        node = inner->children[position];
+    }
+    Leaf *leaf = static_cast<Leaf *>(node);
+    int position = LeafLowerBound(leaf, key);
+    if (position == leaf->size || key < leaf->keys[position]) {
+        // The key doesn't exist in the tree
+        return;
+    }
+    leaf->deleteStoredData(position);
+    for (int i = position; i < leaf->size - 1; ++i) {
+        leaf->keys[i] = leaf->keys[i + 1];
+    }
+    leaf->moveStoredData(position, *leaf, position + 1, leaf->size - position - 1);
+    leaf->size--;
+    numberOfItems--;
+
+    Node *child = leaf;
+    while (depth > 0) {
+        Inner *parent = path[--depth];
+        int childPosition = positions[depth];
+        parent->counts[childPosition]--;
+        if (child->size < rankedNodeMinimum) {
+            FillChild(parent, childPosition);
+        }
+        child = parent;
+    }
+    if (root->size == 0) {
+        delete static_cast<Leaf *>(root);
+        root = nullptr;
+    } else if (!root->isLeaf && root->size == 1) {
+        // The root was left with a single child, the tree shrinks in height
+        Inner *oldRoot = static_cast<Inner *>(root);
+        root = oldRoot->children[0];
+        delete oldRoot;
+    }
+}
+
+/**
+ * Removes and inserts many keys as one batch, the inserted keys get no data
+ * A small batch is applied key by key, a batch large enough compared to the
+ * tree merges the changes into the sorted keys of the tree and rebuilds it in
+ * O(size + batch) without any splits or merges
+ * The result is the same as removing all the removed keys and then inserting
+ * all the inserted keys
+ * @param removedKeys The keys to remove, sorted
+ * @param numberOfRemoved The number of keys to remove
+ * @param insertedKeys The keys to insert, sorted
+ * @param numberOfInserted The number of keys to insert
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::ReplaceKeys(const K *removedKeys, int numberOfRemoved, const K *insertedKeys,
+                                         int numberOfInserted) {
+    if ((long long) (numberOfRemoved + numberOfInserted) * rankedRebuildFactor < numberOfItems) {
+        for (int i = 0; i < numberOfRemoved; ++i) {
+            Remove(removedKeys[i]);
+        }
+        for (int i = 0; i < numberOfInserted; ++i) {
+            Insert(insertedKeys[i]);
+        }
+        return;
+    }
+    K *oldKeys = new K[numberOfItems + 1];
+    T **oldData = new T *[numberOfItems + 1];
+    K *keysEnd = oldKeys;
+    T **dataEnd = oldData;
+    if (root) {
+        FillArrWithEntriesInOrder(root, keysEnd, dataEnd);
+    }
+    DeleteNodes(root, false);
+    root = nullptr;
+
+    K *keys = new K[numberOfItems + numberOfInserted];
+    T **data = new T *[numberOfItems + numberOfInserted];
+    int size = 0;
+    int oldIndex = 0;
+    int removedIndex = 0;
+    int insertedIndex = 0;
+    while (oldIndex < numberOfItems || insertedIndex < numberOfInserted) {
+        if (insertedIndex == numberOfInserted ||
+            (oldIndex < numberOfItems && !(insertedKeys[insertedIndex] < oldKeys[oldIndex]))) {
+            const K &key = oldKeys[oldIndex];
+            while (removedIndex < numberOfRemoved && removedKeys[removedIndex] < key) {
+                removedIndex++;
+            }
+            if (removedIndex < numberOfRemoved && !(key < removedKeys[removedIndex])) {
+                CountedBPlusTreeLeafData<T, S>::DeleteData(oldData[oldIndex]);
+            } else {
+                keys[size] = key;
+                data[size++] = oldData[oldIndex];
+            }
+            oldIndex++;
+        } else {
+            // An inserted key that already exists is ignored, like in Insert
+            if (size == 0 || keys[size - 1] < insertedKeys[insertedIndex]) {
+                keys[size] = insertedKeys[insertedIndex];
+                data[size++] = nullptr;
+            }
+            insertedIndex++;
+        }
+    }
+    delete[] oldKeys;
+    delete[] oldData;
+    root = BuildFromSorted(keys, data, size, pool);
+    numberOfItems = size;
+    delete[] keys;
+    delete[] data;
+}
+
+/**
+ * Inserts many keys as one batch, the inserted keys get no data and keys that
+ * already exist in the tree are ignored
+ * The batch is sorted and applied with ReplaceKeys, so a batch large enough
+ * compared to the tree is merged into it in linear time
+ * @param keys The keys to insert, in any order
+ * @param numberOfKeys The number of keys to insert
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::InsertBatch(const K *keys, int numberOfKeys) {
+    if (numberOfKeys <= 0) {
+        return;
+    }
+    K *sortedKeys = new K[numberOfKeys];
+    for (int i = 0; i < numberOfKeys; ++i) {
+        sortedKeys[i] = keys[i];
+    }
+    std::sort(sortedKeys, sortedKeys + numberOfKeys);
+    ReplaceKeys(nullptr, 0, sortedKeys, numberOfKeys);
+    delete[] sortedKeys;
+}
+
+/**
+ * Splits the tree at a key in O(log n), the tree keeps the keys smaller than
+ * the input key and the rest of the keys move to the returned tree
+ * Every node on the search path is cut into the children before and after
+ * the path, then the pieces of each side are joined bottom up, the joins cost
+ * the differences of heights along the path which add up to O(log n)
+ * Keys keep their data, no data is deleted
+ * @param key The key to split at
+ * @return A tree with the keys not smaller than the input key
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S> CountedBPlusTree<K, T, S>::Split(const K &key) {
+    CountedBPlusTree<K, T, S> greater(pool);
+    if (!root) {
+        return greater;
+    }
+    Node *smallerPieces[rankedMaxDepth];
+    Node *greaterPieces[rankedMaxDepth];
+    int smallerHeights[rankedMaxDepth];
+    int greaterHeights[rankedMaxDepth];
+    K smallerSeparators[rankedMaxDepth];
+    K greaterSeparators[rankedMaxDepth];
+    int depth = 0;
+    int height = Height(root);
+    int smallerCount = 0;
+    Node *node = root;
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = ChildPosition(inner, key);
+        node = inner->children[position];
+        smallerSeparators[depth] = inner->separators[position];
+        int after = inner->size - position - 1;
+        greaterPieces[depth] = nullptr;
+        if (after == 1) {
+            greaterPieces[depth] = inner->children[position + 1];
+            greaterHeights[depth] = height - 1;
+        } else if (after > 1) {
+            Inner *piece = new (S::PoolOf(inner)) Inner();
+            for (int i = 0; i < after; ++i) {
+                piece->separators[i] = inner->separators[position + 1 + i];
+            }
+            memcpy(piece->counts, inner->counts + position + 1, sizeof(int) * after);
+            memcpy(piece->children, inner->children + position + 1, sizeof(Node *) * after);
+            piece->size = after;
+            greaterPieces[depth] = piece;
+            greaterHeights[depth] = height;
+        }
+        if (after > 0) {
+            greaterSeparators[depth] = inner->separators[position + 1];
+        }
+        for (int i = 0; i < position; ++i) {
+            smallerCount += inner->counts[i];
+        }
+        // The node itself is kept as the piece before the path if it has more
+        // than one child there
+        smallerPieces[depth] = nullptr;
+        if (position > 1) {
+            inner->size = position;
+            smallerPieces[depth] = inner;
+            smallerHeights[depth] = height;
+        } else {
+            if (position == 1) {
+                smallerPieces[depth] = inner->children[0];
+                smallerHeights[depth] = height - 1;
+            }
+            delete inner;
+        }
+        depth++;
+        height--;
+    }
+    Leaf *leaf = static_cast<Leaf *>(node);
+    int position = LeafLowerBound(leaf, key);
+    smallerCount += position;
+    Node *smallerRoot = leaf;
+    Node *greaterRoot = nullptr;
+    int smallerHeight = 1;
+    int greaterHeight = 0;
+    if (position < leaf->size) {
+        Leaf *upper = new (S::PoolOf(leaf)) Leaf();
+        for (int i = position; i < leaf->size; ++i) {
+            upper->keys[i - position] = leaf->keys[i];
+        }
+        upper->moveStoredData(0, *leaf, position, leaf->size - position);
+        upper->size = leaf->size - position;
+        leaf->size = position;
+        greaterRoot = upper;
+        greaterHeight = 1;
+    }
+    if (position == 0) {
+        delete leaf;
+        smallerRoot = nullptr;
+        smallerHeight = 0;
+    }
+    while (depth > 0) {
+        depth--;
+        smallerRoot = JoinNodes(smallerPieces[depth], smallerHeights[depth], smallerRoot, smallerHeight,
+                                smallerSeparators[depth], smallerHeight, pool);
+        greaterRoot = JoinNodes(greaterRoot, greaterHeight, greaterPieces[depth], greaterHeights[depth],
+                                greaterSeparators[depth], greaterHeight, pool);
+    }
+    root = smallerRoot;
+    greater.root = greaterRoot;
+    greater.numberOfItems = numberOfItems - smallerCount;
+    numberOfItems = smallerCount;
+    return greater;
+}
+
+/**
+ * Joins two trees in O(log n), every key of the left tree must be smaller than
+ * every key of the right tree
+ * @param left The tree with the smaller keys, left empty
+ * @param right The tree with the greater keys, left empty
+ * @return A tree with the keys of both trees
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S> CountedBPlusTree<K, T, S>::Join(CountedBPlusTree<K, T, S> &left, CountedBPlusTree<K, T, S> &right) {
+    CountedBPlusTree<K, T, S> joined(left.pool);
+    K separator = K();
+    if (right.root) {
+        Node *node = right.root;
+        while (!node->isLeaf) {
+            node = static_cast<Inner *>(node)->children[0];
+        }
+        separator = static_cast<Leaf *>(node)->keys[0];
+    }
+    int height;
+    joined.root = JoinNodes(left.root, Height(left.root), right.root, Height(right.root), separator, height,
+                            left.pool);
+    joined.numberOfItems = left.numberOfItems + right.numberOfItems;
+    left.root = nullptr;
+    left.numberOfItems = 0;
+    right.root = nullptr;
+    right.numberOfItems = 0;
+    return joined;
+}
+
+/**
+ * Moves the keys in [from, to) with their data to a new tree in O(log n) by
+ * two splits and a join, without splitting or merging nodes key by key
+ * An empty range is found by a single search and leaves the tree untouched
+ * @param from The minimal key of the range
+ * @param to The key right after the range
+ * @return A tree with the keys of the range
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S> CountedBPlusTree<K, T, S>::ExtractRange(const K &from, const K &to) {
+    Iterator first = IteratorFrom(from);
+    if (first == end() || !(*first < to)) {
+        return CountedBPlusTree<K, T, S>(pool);
+    }
+    CountedBPlusTree<K, T, S> range = Split(from);
+    CountedBPlusTree<K, T, S> greater = range.Split(to);
+    *this = Join(*this, greater);
+    return range;
+}
+
+/**
+ * Removes the keys in [from, to) and deletes their data in O(log n + k) for
+ * k removed keys
+ * @param from The minimal key of the range
+ * @param to The key right after the range
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::RemoveRange(const K &from, const K &to) {
+    ExtractRange(from, to);
+}
+
+/**
+ * Moves the nodes of a subtree and their data to the lowest free slots of
+ * their arenas, a node is moved when the pass enters it and it's keys are
+ * visited in ascending order starting at the cursor
+ * @param node The link to the root of the subtree, fixed if the root moves
+ * @param cursor The position of the pass, updated when the budget runs out
+ * @param budget The number of keys the slice may still visit
+ * @return True if the pass reached the end of the subtree
+ */
+template<class K, class T, class S>
+bool CountedBPlusTree<K, T, S>::RelocateSubtree(Node *&node, RelocationCursor<K> &cursor, int &budget) {
+    if (node->isLeaf) {
+        Leaf *leaf = S::template Relocate<Leaf>(static_cast<Leaf *>(node));
+        node = leaf;
+        int position = cursor.isStarted ? LeafLowerBound(leaf, cursor.nextKey) : 0;
+        for (; position < leaf->size; ++position) {
+            if (budget <= 0) {
+                cursor.nextKey = leaf->keys[position];
+                cursor.isStarted = true;
+                return false;
+            }
+            budget--;
+            leaf->relocateStoredData(position);
+        }
+        return true;
+    }
+    Inner *inner = S::template Relocate<Inner>(static_cast<Inner *>(node));
+    node = inner;
+    // Children before the cursor hold only keys the pass already visited
+    int position = cursor.isStarted ? ChildPosition(inner, cursor.nextKey) : 0;
+    for (; position < inner->size; ++position) {
+        if (!RelocateSubtree(inner->children[position], cursor, budget)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Moves the nodes and their data to the lowest free slots of their arenas in
+ * ascending key order, so the leaves that move end up in dense in order runs
+ * @param cursor The position of the pass in this tree, updated when the
+ * budget runs out and reset when the pass reaches the end of the tree
+ * @param budget The number of keys this slice may still visit, decreased by
+ * the keys visited
+ * @return True if the pass reached the end of the tree
+ */
+template<class K, class T, class S>
+bool CountedBPlusTree<K, T, S>::RelocateNodes(RelocationCursor<K> &cursor, int &budget) {
+    if (root && !RelocateSubtree(root, cursor, budget)) {
+        return false;
+    }
+    cursor = RelocationCursor<K>();
+    return true;
+}
+
+/**
+ * Forgets the nodes of the tree without deleting them, leaving it empty
+ */
+template<class K, class T, class S>
+void CountedBPlusTree<K, T, S>::MarkRootAsNullptr() {
+    root = nullptr;
+    numberOfItems = 0;
+}
+
+/**
+ * Finds the key with the input rank, where the maximal key has rank 1
+ * @param searchRank The rank of the key to find, between 1 and the size of
+ * the tree
+ * @return The key with the input rank
+ */
+template<class K, class T, class S>
+K CountedBPlusTree<K, T, S>::FindByRank(int searchRank) {
+    if (searchRank < 1 || searchRank > numberOfItems) {
+        return K();
+    }
+    // Position of the key in ascending order
+    int index = numberOfItems - searchRank;
+    Node *node = root;
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = 0;
+        while (index >= inner->counts[position]) {
+            index -= inner->counts[position];
+            position++;
+        }
+        node = inner->children[position];
+    }
+    return static_cast<Leaf *>(node)->keys[index];
+}
+
+/**
+ * Checks if the tree is empty
+ * @return True if the tree has no keys, False otherwise
+ */
+template<class K, class T, class S>
+bool CountedBPlusTree<K, T, S>::IsRootNull() {
+    return (root == nullptr);
+}
+
+/**
+ * Returns the number of keys stored in the tree
+ */
+template<class K, class T, class S>
+int CountedBPlusTree<K, T, S>::getSize() {
+    return numberOfItems;
+}
+
+/**
+ * Returns an iterator over the tree in ascending key order
+ * @return An iterator pointing at the minimal key
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Iterator CountedBPlusTree<K, T, S>::begin() {
+    Iterator iterator;
+    if (root) {
+        iterator.DescendToEdge(root);
+    }
+    return iterator;
+}
+
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Iterator CountedBPlusTree<K, T, S>::end() {
+    return Iterator();
+}
+
+/**
+ * Returns an iterator over the tree in descending key order, which is the
+ * order of increasing rank
+ * @return An iterator pointing at the maximal key
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::ReverseIterator CountedBPlusTree<K, T, S>::rbegin() {
+    ReverseIterator iterator;
+    if (root) {
+        iterator.DescendToEdge(root);
+    }
+    return iterator;
+}
+
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::ReverseIterator CountedBPlusTree<K, T, S>::rend() {
+    return ReverseIterator();
+}
+
+/**
+ * Returns an iterator in ascending key order starting at a key
+ * @param key The key to start from
+ * @return An iterator pointing at the first key not smaller than the input key
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Iterator CountedBPlusTree<K, T, S>::IteratorFrom(const K &key) {
+    Iterator iterator;
+    if (root) {
+        iterator.DescendToKey(root, key);
+    }
+    return iterator;
+}
+
+/**
+ * Returns an iterator in descending key order starting at a key
+ * @param key The key to start from
+ * @return An iterator pointing at the last key not greater than the input key
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::ReverseIterator CountedBPlusTree<K, T, S>::ReverseIteratorFrom(const K &key) {
+    ReverseIterator iterator;
+    if (root) {
+        iterator.DescendToKey(root, key);
+    }
+    return iterator;
+}
+
+/**
+ * Returns an iterator in ascending key order, which is the order of
+ * decreasing rank, starting at a rank
+ * @param rank The rank to start from, where the maximal key has rank 1
+ * @return An iterator pointing at the key with the input rank, end() if there
+ * is no such rank
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::Iterator CountedBPlusTree<K, T, S>::IteratorAtRank(int rank) {
+    Iterator iterator;
+    if (rank >= 1 && rank <= numberOfItems) {
+        iterator.DescendToIndex(root, numberOfItems - rank);
+    }
+    return iterator;
+}
+
+/**
+ * Returns an iterator in descending key order, which is the order of
+ * increasing rank, starting at a rank
+ * @param rank The rank to start from, where the maximal key has rank 1
+ * @return An iterator pointing at the key with the input rank, rend() if there
+ * is no such rank
+ */
+template<class K, class T, class S>
+typename CountedBPlusTree<K, T, S>::ReverseIterator CountedBPlusTree<K, T, S>::ReverseIteratorAtRank(int rank) {
+    ReverseIterator iterator;
+    if (rank >= 1 && rank <= numberOfItems) {
+        iterator.DescendToIndex(root, numberOfItems - rank);
+    }
+    return iterator;
+}
+
+/**
+ * Deletes all nodes stored in the tree, including the dynamic data stored in them
+ */
+template<class K, class T, class S>
+CountedBPlusTree<K, T, S>::~CountedBPlusTree() {
+    DeleteNodes(root);
+    root = nullptr;
+}
+
+/**
+ * =============================================================================
+ * Iterator Functions Implementation
+ * =============================================================================
+ */
+
+/**
+ * Descends from a node to the first key of it's subtree in the scan order,
+ * recording the path
+ * @param node The node to descend from, the path above it is already recorded
+ */
+template<class K, class T, bool isReverse, class S>
+void CountedBPlusTreeIterator<K, T, isReverse, S>::DescendToEdge(Node *node) {
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = isReverse ? inner->size - 1 : 0;
+        path[depth] = inner;
+        positions[depth++] = position;
+        node = inner->children[position];
+    }
+    leaf = static_cast<Leaf *>(node);
+    index = isReverse ? leaf->size - 1 : 0;
+}
+
+/**
+ * Descends to the first key not smaller than the input key, or to the last key
+ * not greater than it in a reverse scan
+ * @param root The root of the tree
+ * @param key The key to search for
+ */
+template<class K, class T, bool isReverse, class S>
+void CountedBPlusTreeIterator<K, T, isReverse, S>::DescendToKey(Node *root, const K &key) {
+    Node *node = root;
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = CountedBPlusTree<K, T, S>::ChildPosition(inner, key);
+        path[depth] = inner;
+        positions[depth++] = position;
+        node = inner->children[position];
+    }
+    leaf = static_cast<Leaf *>(node);
+    index = CountedBPlusTree<K, T, S>::LeafLowerBound(leaf, key);
+    if (isReverse && (index == leaf->size || key < leaf->keys[index])) {
+        // The key doesn't exist, the scan starts at the key before it
+        index--;
+    }
+    if (index < 0 || index == leaf->size) {
+        // Separators can be smaller than the keys under them after removals,
+        // so the wanted key may be the edge of the neighbouring leaf
+        MoveToNextLeaf();
+    }
+}
+
+/**
+ * Descends to the key with the input position in ascending order
+ * @param root The root of the tree
+ * @param keyIndex The position of the key, between 0 and the size of the tree
+ * minus one
+ */
+template<class K, class T, bool isReverse, class S>
+void CountedBPlusTreeIterator<K, T, isReverse, S>::DescendToIndex(Node *root, int keyIndex) {
+    Node *node = root;
+    while (!node->isLeaf) {
+        Inner *inner = static_cast<Inner *>(node);
+        int position = 0;
+        while (keyIndex >= inner->counts[position]) {
+            keyIndex -= inner->counts[position];
+            position++;
+        }
+        path[depth] = inner;
+        positions[depth++] = position;
+        node = inner->children[position];
+    }
+    leaf = static_cast<Leaf *>(node);
+    index = keyIndex;
+}
+
+/**
+ * Moves to the edge of the next leaf in the scan order, climbing to the first
+ * ancestor that has another child in that direction, or to the end of the
+ * scan if there is no such ancestor
+ */
+template<class K, class T, bool isReverse, class S>
+void CountedBPlusTreeIterator<K, T, isReverse, S>::MoveToNextLeaf() {
+    while (depth > 0) {
+        Inner *inner = path[depth - 1];
+        int position = positions[depth - 1] + (isReverse ? -1 : 1);
+        if (position >= 0 && position < inner->size) {
+            positions[depth - 1] = position;
+            DescendToEdge(inner->children[position]);
+            return;
+        }
+        depth--;
+    }
+    leaf = nullptr;
+    index = 0;
+}
+
+template<class K, class T, bool isReverse, class S>
+const K &CountedBPlusTreeIterator<K, T, isReverse, S>::operator*() const {
+    return leaf->keys[index];
+}
+
+template<class K, class T, bool isReverse, class S>
+const K *CountedBPlusTreeIterator<K, T, isReverse, S>::operator->() const {
+    return &leaf->keys[index];
+}
+
+template<class K, class T, bool isReverse, class S>
+T *CountedBPlusTreeIterator<K, T, isReverse, S>::getData() const {
+    return leaf->getStoredData(index);
+}
+
+/**
+ * Moves to the next key in the scan order
+ * @return This iterator
+ */
+template<class K, class T, bool isReverse, class S>
+CountedBPlusTreeIterator<K, T, isReverse, S> &CountedBPlusTreeIterator<K, T, isReverse, S>::operator++() {
+    index += isReverse ? -1 : 1;
+    if (index < 0 || index == leaf->size) {
+        MoveToNextLeaf();
+    }
+    return *this;
+}
+
+template<class K, class T, bool isReverse, class S>
+CountedBPlusTreeIterator<K, T, isReverse, S> CountedBPlusTreeIterator<K, T, isReverse, S>::operator++(int) {
+    CountedBPlusTreeIterator<K, T, isReverse, S> previous = *this;
+    ++*this;
+    return previous;
+}
+
+template<class K, class T, bool isReverse, class S>
+bool CountedBPlusTreeIterator<K, T, isReverse, S>::operator==(
+        const CountedBPlusTreeIterator<K, T, isReverse, S> &other) const {
+    return leaf == other.leaf && index == other.index;
+}
+
+template<class K, class T, bool isReverse, class S>
+bool CountedBPlusTreeIterator<K, T, isReverse, S>::operator!=(
+        const CountedBPlusTreeIterator<K, T, isReverse, S> &other) const {
+    return !(*this == other);
+}
+
+#endif //WET2_COUNTEDBPLUSTREE_H
@@ -0,0 +1,95 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_HASHPOLICY_H
+#define WET2_HASHPOLICY_H
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+/**
+ * Hash policies for HashTable
+ * A policy maps a key to a 64 bit hash whose top bits are well mixed, the
+ * table takes the group index from the top bits and the control byte from the
+ * bits right below them, so no modulo is ever needed
+ */
+
+const double goldenFactor = (std::sqrt(5) - 1) / 2;
+
+/**
+ * Fibonacci (multiply-shift) hashing in integer arithmetic
+ * Multiplying by 2^64 / phi keeps the fraction of key * phi in the 64 bits of
+ * the product, which is the same value GoldenRatioHash computes in floating
+ * point, without the modf/floor calls and without losing precision on large keys
+ */
+struct FibonacciHash {
+    static const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    static const bool isSeeded = false;
+
+    void Reseed() {}
+
+    uint64_t operator()(int key) const {
+        return (uint64_t) (uint32_t) key * multiplier;
+    }
+};
+
+/**
+ * Golden ratio multiplicative hashing in floating point, the fraction of
+ * key * goldenFactor is scaled to the full 64 bit range
+ * Kept for comparison with FibonacciHash
+ */
+struct GoldenRatioHash {
+    static const bool isSeeded = false;
+
+    void Reseed() {}
+
+    uint64_t operator()(int key) const {
+        double temp = key * goldenFactor;
+        double num;
+        double frac = std::modf(temp, &num);
+        if (frac < 0) {
+            frac += 1;
+        }
+        return (uint64_t) (frac * 18446744073709551616.0);
+    }
+};
+
+/**
+ * Multiply-add-shift hashing with a random odd multiplier and a random
+ * increment drawn per instance, a universal family so a feed of keys crafted
+ * against one table (or against FibonacciHash) doesn't collide in another
+ */
+struct SeededHash {
+    static const bool isSeeded = true;
+    uint64_t multiplier;
+    uint64_t increment;
+
+    SeededHash() {
+        Reseed();
+    }
+
+    uint64_t operator()(int key) const {
+        return (uint64_t) (uint32_t) key * multiplier + increment;
+    }
+
+    void Reseed() {
+        std::random_device device;
+        uint64_t seed = ((uint64_t) device() << 32) ^ device();
+        multiplier = SplitMix(seed) | 1;
+        increment = SplitMix(seed);
+    }
+
+    /**
+     * Advances a splitmix64 generator and returns it's next output
+     */
+    static uint64_t SplitMix(uint64_t &state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif //WET2_HASHPOLICY_H
@@ -5,103 +5,357 @@
 #ifndef WET2_HASHTABLE_H
 #define WET2_HASHTABLE_H
 
-#include "List.h"
-#include <cmath>
+#include "library2.h"
+#include "HashPolicy.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <new>
 #include <ostream>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Control byte values of the open addressing table
+ * A full slot stores 7 bits of it's hash (0..127), empty and deleted
+ * slots have the sign bit set so a single movemask can find them
+ */
+const signed char ctrlEmpty = -128;
+const signed char ctrlDeleted = -2;
+const int groupWidth = 16;
+
+/**
+ * A group of 16 control bytes that is probed as a single unit
+ * Uses SSE2 compares when available and falls back to a plain byte scan
+ * Every match function returns a bit mask where bit i marks slot i of the group
+ */
+class HashGroup {
+private:
+#ifdef __SSE2__
+    __m128i ctrl;
+#else
+    const signed char *ctrl;
+#endif
+
+public:
+    explicit HashGroup(const signed char *position) {
+#ifdef __SSE2__
+        ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+#else
+        ctrl = position;
+#endif
+    }
+
+    unsigned int MatchByte(signed char hash) const {
+#ifdef __SSE2__
+        return (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(hash)));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < groupWidth; ++i) {
+            if (ctrl[i] == hash) {
+                mask |= (1u << i);
+            }
+        }
+        return mask;
+#endif
+    }
 
-using std::sqrt;
-using std::modf;
-using std::floor;
+    unsigned int MatchEmpty() const {
+        return MatchByte(ctrlEmpty);
+    }
+
+    unsigned int MatchEmptyOrDeleted() const {
+#ifdef __SSE2__
+        return (unsigned int) _mm_movemask_epi8(ctrl);
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < groupWidth; ++i) {
+            if (ctrl[i] < 0) {
+                mask |= (1u << i);
+            }
+        }
+        return mask;
+#endif
+    }
+
+    /**
+     * Returns the index of the lowest set bit of a non empty match mask
+     */
+    static int LowestBit(unsigned int mask) {
+        return __builtin_ctz(mask);
+    }
+};
 
-const double goldenFactor = (sqrt(5) - 1) / 2;
 
-template<class T>
+/**
+ * Number of old slots moved into the new array by every insert and remove
+ * while an incremental resize is in progress
+ */
+const int migrationStep = 4 * groupWidth;
+
+/**
+ * The table grows when more than 7/8 of the slots are used and shrinks when
+ * less than 1/8 of them hold records, a resize leaves the load at 7/16 or 1/4
+ * so alternating inserts and removes around a threshold can't trigger another
+ * resize right away
+ */
+const int maxLoadEighths = 7;
+const int minLoadEighths = 1;
+
+/**
+ * An insert that had to probe more than maxProbeGroups groups makes a table
+ * with a seeded hash policy draw a new seed and rehash, at most maxReseeds
+ * times between two resizes
+ */
+const int maxProbeGroups = 16;
+const int maxReseeds = 4;
+
+/**
+ * Generic Template Class for an open addressing hash table
+ * Records of type T are stored inline in the slot array (no node or bucket
+ * allocations), the slots are split into groups of 16 whose control bytes are
+ * probed together, so a lookup usually touches one control line and one slot
+ * In incremental resize mode the previous slot array is kept after a resize
+ * and drained a few groups at a time by later inserts and removes, instead of
+ * rehashing every record on the call that crossed the load threshold
+ * @tparam T Type of the stored record, must be move constructible
+ * @tparam H Hash policy mapping a key to a 64 bit hash (see HashPolicy.h)
+ */
+template<class T, class H = SeededHash>
 class HashTable {
 private:
+    struct Slot {
+        int key;
+        T data;
+
+        Slot(int key, T &&data) : key(key), data(std::move(data)) {}
+    };
+
+    struct SlotArray {
+        signed char *controlBytes = nullptr;
+        Slot *slots = nullptr;
+        int size = 0;
+        int numberOfDeleted = 0;
+    };
+
     int numberOfItems = 0;
-    int size = 2;
-    List<T> **hashArray;
+    int minimumSize = groupWidth;
+    bool incrementalResize;
+    SlotArray table;
+    SlotArray oldTable;
+    int migratedIndex = 0;
+    int reseedsSinceResize = 0;
+    H hashFunction;
+
+    static int GroupOf(uint64_t hash, int size);
+
+    static signed char ControlOf(uint64_t hash, int size);
+
+    int FindIndex(const SlotArray &array, int key);
+
+    static int FindInsertIndex(const SlotArray &array, uint64_t hash, int &probeGroups);
+
+    static void AllocateArray(SlotArray &array, int nSize);
+
+    static void FreeArray(SlotArray &array);
+
+    static void EraseSlot(SlotArray &array, int index);
+
+    void MoveSlot(Slot &slot);
+
+    void MigrateSlots(int numberOfSlots);
+
+    static int SizeForRecords(int numberOfRecords);
 
-    int HashFunction(int key);
+    void Rehash(int nSize);
+
+    void ReseedAndRehash();
 
     bool ExtendArray();
 
     bool ShrinkArray();
 
 public:
-    HashTable();
+    explicit HashTable(bool incrementalResize = false);
+
+    HashTable(const HashTable<T, H> &other) = delete;
 
-    StatusType Insert(int key, T *data);
+    HashTable<T, H> &operator=(const HashTable<T, H> &other) = delete;
+
+    StatusType Insert(int key, T &&data);
 
     StatusType Find(int key);
 
     int getSize();
 
-    ListNode<T> *FindNode(int key);
+    int getNumberOfPositions();
+
+    T *RecordAt(int position);
+
+    bool IsResizing();
+
+    StatusType Reserve(int numberOfRecords);
+
+    StatusType SetMinimumCapacity(int numberOfRecords);
+
+    T *FindData(int key);
+
+    void Prefetch(int key);
 
     StatusType Remove(int key);
 
+    void Clear();
+
     void PrintTable();
 
     ~HashTable();
 
 };
 
-template<class T>
-HashTable<T>::HashTable() {
-    hashArray = new List<T> *[size];
-    for (int i = 0; i < size; ++i) {
-        hashArray[i] = new List<T>();
+/**
+ * Creates an empty hash table with a single group of slots
+ * @tparam T Type of the stored record
+ * @param incrementalResize True to spread resizes over the following operations
+ */
+template<class T, class H>
+HashTable<T, H>::HashTable(bool incrementalResize): incrementalResize(incrementalResize) {
+    AllocateArray(table, groupWidth);
+}
+
+/**
+ * Allocates an empty control array and uninitialized slot storage
+ * @tparam T Type of the stored record
+ * @param array The slot array to allocate
+ * @param nSize The number of slots, a power of two multiple of the group width
+ */
+template<class T, class H>
+void HashTable<T, H>::AllocateArray(SlotArray &array, int nSize) {
+    array.controlBytes = new signed char[nSize];
+    memset(array.controlBytes, ctrlEmpty, nSize);
+    array.slots = static_cast<Slot *>(::operator new(sizeof(Slot) * nSize));
+    array.size = nSize;
+    array.numberOfDeleted = 0;
+}
+
+/**
+ * Destroys the records left in a slot array and releases it's memory
+ * @tparam T Type of the stored record
+ * @param array The slot array to free
+ */
+template<class T, class H>
+void HashTable<T, H>::FreeArray(SlotArray &array) {
+    for (int i = 0; i < array.size; ++i) {
+        if (array.controlBytes[i] >= 0) {
+            array.slots[i].~Slot();
+        }
     }
+    delete[] array.controlBytes;
+    ::operator delete(array.slots);
+    array = SlotArray();
 }
 
-template<class T>
-StatusType HashTable<T>::Insert(int key, T *data) {
-    int index = HashFunction(key);
-    if (hashArray[index]->Find(key)) {
+template<class T, class H>
+StatusType HashTable<T, H>::Insert(int key, T &&data) {
+    if (FindIndex(table, key) >= 0 || (oldTable.slots && FindIndex(oldTable, key) >= 0)) {
         // The key already exists in the hash table
         return FAILURE;
     }
-    hashArray[index]->Insert(key, data);
-    numberOfItems++;
-    double ratio = (double) numberOfItems / size;
-    if (ratio > 0.5) {
-        //std::cout << "EXTENDING ratio is: "<< ratio << "number of items is: " << numberOfItems << "size is: " << size << std::endl;
-        if (!ExtendArray()) {
-            return FAILURE;
+    if (oldTable.slots) {
+        MigrateSlots(migrationStep);
+    }
+    if ((numberOfItems + table.numberOfDeleted + 1) * 8 > table.size * maxLoadEighths) {
+        // The table is too full to keep probe sequences short, either grow it
+        // or clean the tombstones out if most of the used slots are deleted
+        if (numberOfItems * 16 > table.size * maxLoadEighths) {
+            if (!ExtendArray()) {
+                return FAILURE;
+            }
+        } else {
+            Rehash(table.size);
         }
     }
+    uint64_t hash = hashFunction(key);
+    int probeGroups = 0;
+    int index = FindInsertIndex(table, hash, probeGroups);
+    if (table.controlBytes[index] == ctrlDeleted) {
+        table.numberOfDeleted--;
+    }
+    table.controlBytes[index] = ControlOf(hash, table.size);
+    new(&table.slots[index]) Slot(key, std::move(data));
+    numberOfItems++;
+    if (H::isSeeded && probeGroups > maxProbeGroups && reseedsSinceResize < maxReseeds) {
+        // The keys pile up in a few groups, most likely crafted against the
+        // current seed
+        ReseedAndRehash();
+    }
     return SUCCESS;
 }
 
-template<class T>
-StatusType HashTable<T>::Find(int key) {
-    int index = HashFunction(key);
-    if (hashArray[index]->Find(key)) {
+template<class T, class H>
+StatusType HashTable<T, H>::Find(int key) {
+    if (FindData(key)) {
         return SUCCESS;
     }
     return FAILURE;
 }
 
-template<class T>
-ListNode<T> *HashTable<T>::FindNode(int key) {
-    int index = HashFunction(key);
-    return hashArray[index]->FindNode(key);
+/**
+ * Returns a pointer to the record stored with the input key
+ * The pointer is only valid until the next insertion or removal
+ * @tparam T Type of the stored record
+ * @param key The key of the record
+ * @return A pointer to the record if it exists, nullptr otherwise
+ */
+template<class T, class H>
+T *HashTable<T, H>::FindData(int key) {
+    int index = FindIndex(table, key);
+    if (index >= 0) {
+        return &table.slots[index].data;
+    }
+    if (oldTable.slots) {
+        // The record might not have been migrated yet
+        index = FindIndex(oldTable, key);
+        if (index >= 0) {
+            return &oldTable.slots[index].data;
+        }
+    }
+    return nullptr;
 }
 
-template<class T>
-StatusType HashTable<T>::Remove(int key) {
-    int index = HashFunction(key);
-    if (!hashArray[index]->Find(key)) {
-        // The key doesn't exist in the hash table
-        return FAILURE;
+/**
+ * Issues prefetches for the first group a lookup of the key will probe, so a
+ * later FindData of the same key doesn't wait on memory
+ * @tparam T Type of the stored record
+ * @param key The key that will be looked up
+ */
+template<class T, class H>
+void HashTable<T, H>::Prefetch(int key) {
+    int groupStart = GroupOf(hashFunction(key), table.size) * groupWidth;
+    __builtin_prefetch(table.controlBytes + groupStart);
+    __builtin_prefetch(table.slots + groupStart);
+}
+
+template<class T, class H>
+StatusType HashTable<T, H>::Remove(int key) {
+    int index = FindIndex(table, key);
+    if (index >= 0) {
+        EraseSlot(table, index);
+    } else {
+        if (!oldTable.slots || (index = FindIndex(oldTable, key)) < 0) {
+            // The key doesn't exist in the hash table
+            return FAILURE;
+        }
+        EraseSlot(oldTable, index);
     }
-    hashArray[index]->Remove(key);
     numberOfItems--;
-    double ratio = (double) numberOfItems / size;
-    if (ratio < 0.25) {
-        //std::cout << "SHRINKING ratio is: "<< ratio << "number of items is: " << numberOfItems << "size is: " << size << std::endl;
+    if (oldTable.slots) {
+        MigrateSlots(migrationStep);
+    }
+    if (table.size > minimumSize && numberOfItems * 8 < table.size * minLoadEighths) {
         if (!ShrinkArray()) {
             return FAILURE;
         }
@@ -110,87 +364,324 @@ StatusType HashTable<T>::Remove(int key) {
     return SUCCESS;
 }
 
-template<class T>
-int HashTable<T>::HashFunction(int key) {
-    double temp = key * goldenFactor;
-    double num;
-    double frac = modf(temp, &num);
-    int index = floor(size * frac);
-    return index;
+/**
+ * Destroys the record in a slot and marks the slot as free
+ * @tparam T Type of the stored record
+ * @param array The slot array holding the record
+ * @param index The index of the slot
+ */
+template<class T, class H>
+void HashTable<T, H>::EraseSlot(SlotArray &array, int index) {
+    array.slots[index].~Slot();
+    int groupStart = index & ~(groupWidth - 1);
+    if (HashGroup(array.controlBytes + groupStart).MatchEmpty()) {
+        // No probe sequence ever continued past this group, the slot can be
+        // reused as a plain empty slot
+        array.controlBytes[index] = ctrlEmpty;
+    } else {
+        array.controlBytes[index] = ctrlDeleted;
+        array.numberOfDeleted++;
+    }
 }
 
-template<class T>
-bool HashTable<T>::ExtendArray() {
-    size = size * 2;
-    List<T> **nTable = new List<T> *[size];
-    for (int i = 0; i < size; ++i) {
-        nTable[i] = new List<T>();
+/**
+ * Returns the first group in the probe sequence of a hash, taken from the top
+ * bits of the hash, a shift instead of a modulo since the size is a power of two
+ */
+template<class T, class H>
+int HashTable<T, H>::GroupOf(uint64_t hash, int size) {
+    int groupBits = __builtin_ctz(size / groupWidth);
+    if (groupBits == 0) {
+        return 0;
     }
+    return (int) (hash >> (64 - groupBits));
+}
+
+/**
+ * Returns the control byte of a hash, the 7 bits right below the group bits
+ */
+template<class T, class H>
+signed char HashTable<T, H>::ControlOf(uint64_t hash, int size) {
+    int groupBits = __builtin_ctz(size / groupWidth);
+    return (signed char) ((hash >> (57 - groupBits)) & 0x7F);
+}
 
-    for (int i = 0; i < size / 2; ++i) {
-        List<T> *oldListAtIndex = hashArray[i];
-        ListNode<T> *oldNode = oldListAtIndex->ResetIterator();
-        while (oldNode) {
-            int index = HashFunction(oldNode->getKey());
-            nTable[index]->Insert(oldNode->getKey(), oldNode->getData());
-            oldNode->removeDataPointer();
-            oldNode = oldListAtIndex->NextIteration();
+/**
+ * Probes a slot array for the slot that stores the input key
+ * Groups are visited in triangular order, which covers every group of a
+ * power of two sized array
+ * @return The index of the slot, -1 if the key isn't in the array
+ */
+template<class T, class H>
+int HashTable<T, H>::FindIndex(const SlotArray &array, int key) {
+    uint64_t hash = hashFunction(key);
+    signed char control = ControlOf(hash, array.size);
+    int groupMask = array.size / groupWidth - 1;
+    int group = GroupOf(hash, array.size);
+    for (int step = 1;; ++step) {
+        int groupStart = group * groupWidth;
+        HashGroup probed(array.controlBytes + groupStart);
+        unsigned int matches = probed.MatchByte(control);
+        while (matches) {
+            int index = groupStart + HashGroup::LowestBit(matches);
+            if (array.slots[index].key == key) {
+                return index;
+            }
+            matches &= matches - 1;
+        }
+        if (probed.MatchEmpty() || step > groupMask) {
+            return -1;
         }
-        delete oldListAtIndex;
-        hashArray[i] = nullptr;
+        group = (group + step) & groupMask;
     }
-    delete[] hashArray;
-    hashArray = nTable;
-    return true;
 }
 
-template<class T>
-bool HashTable<T>::ShrinkArray() {
-    size = size / 2;
-    List<T> **nTable = new List<T> *[size];
-    for (int i = 0; i < size; ++i) {
-        nTable[i] = new List<T>();
+/**
+ * Finds the first empty or deleted slot in the probe sequence of a hash
+ * The arrays always keep free slots so the search terminates
+ * @param probeGroups Set to the number of groups that were probed
+ */
+template<class T, class H>
+int HashTable<T, H>::FindInsertIndex(const SlotArray &array, uint64_t hash, int &probeGroups) {
+    int groupMask = array.size / groupWidth - 1;
+    int group = GroupOf(hash, array.size);
+    for (int step = 1;; ++step) {
+        int groupStart = group * groupWidth;
+        unsigned int available = HashGroup(array.controlBytes + groupStart).MatchEmptyOrDeleted();
+        if (available) {
+            probeGroups = step;
+            return groupStart + HashGroup::LowestBit(available);
+        }
+        group = (group + step) & groupMask;
     }
+}
 
-    for (int i = 0; i < size * 2; ++i) {
-        List<T> *oldListAtIndex = hashArray[i];
-        ListNode<T> *oldNode = oldListAtIndex->ResetIterator();
-        while (oldNode) {
-            int index = HashFunction(oldNode->getKey());
-            nTable[index]->Insert(oldNode->getKey(), oldNode->getData());
-            oldNode->removeDataPointer();
-            oldNode = oldListAtIndex->NextIteration();
+/**
+ * Moves a record into the current slot array, the record is moved and not
+ * copied so no memory is allocated for it
+ * @param slot The old slot of the record, destroyed after the move
+ */
+template<class T, class H>
+void HashTable<T, H>::MoveSlot(Slot &slot) {
+    uint64_t hash = hashFunction(slot.key);
+    int probeGroups = 0;
+    int index = FindInsertIndex(table, hash, probeGroups);
+    if (table.controlBytes[index] == ctrlDeleted) {
+        table.numberOfDeleted--;
+    }
+    table.controlBytes[index] = ControlOf(hash, table.size);
+    new(&table.slots[index]) Slot(slot.key, std::move(slot.data));
+    slot.~Slot();
+}
+
+/**
+ * Moves the next records of the draining slot array into the current one and
+ * releases the draining array once all of it has been moved
+ * @param numberOfSlots The number of old slots to scan
+ */
+template<class T, class H>
+void HashTable<T, H>::MigrateSlots(int numberOfSlots) {
+    int last = std::min(oldTable.size, migratedIndex + numberOfSlots);
+    for (; migratedIndex < last; ++migratedIndex) {
+        if (oldTable.controlBytes[migratedIndex] >= 0) {
+            MoveSlot(oldTable.slots[migratedIndex]);
+            // Keeping the probe sequences of the records that are still
+            // waiting intact
+            oldTable.controlBytes[migratedIndex] = ctrlDeleted;
         }
-        delete oldListAtIndex;
-        hashArray[i] = nullptr;
     }
-    delete[] hashArray;
-    hashArray = nTable;
+    if (migratedIndex == oldTable.size) {
+        FreeArray(oldTable);
+        migratedIndex = 0;
+    }
+}
+
+/**
+ * Replaces the slot array with a new array of the given size
+ * In incremental mode the previous array is only drained by later operations,
+ * otherwise every record is moved right away
+ * @param nSize The new number of slots
+ */
+template<class T, class H>
+void HashTable<T, H>::Rehash(int nSize) {
+    if (oldTable.slots) {
+        // Only one array can be drained at a time
+        MigrateSlots(oldTable.size);
+    }
+    oldTable = table;
+    migratedIndex = 0;
+    AllocateArray(table, nSize);
+    if (!incrementalResize) {
+        MigrateSlots(oldTable.size);
+    }
+}
+
+/**
+ * Returns the smallest valid size that holds the given number of records
+ * without crossing the growth threshold
+ * @param numberOfRecords The number of records
+ * @return A power of two multiple of the group width
+ */
+template<class T, class H>
+int HashTable<T, H>::SizeForRecords(int numberOfRecords) {
+    int nSize = groupWidth;
+    while ((long long) numberOfRecords * 8 > (long long) nSize * maxLoadEighths) {
+        nSize *= 2;
+    }
+    return nSize;
+}
+
+/**
+ * Grows the table so the given number of records can be stored without any
+ * further resize, never shrinks the table
+ * @tparam T Type of the stored record
+ * @param numberOfRecords The number of records to make room for
+ * @return INVALID_INPUT for a negative number of records, SUCCESS otherwise
+ */
+template<class T, class H>
+StatusType HashTable<T, H>::Reserve(int numberOfRecords) {
+    if (numberOfRecords < 0) {
+        return INVALID_INPUT;
+    }
+    int nSize = SizeForRecords(numberOfRecords);
+    if (nSize > table.size) {
+        Rehash(nSize);
+    }
+    return SUCCESS;
+}
+
+/**
+ * Sets the size the table never shrinks below to the size that holds the
+ * given number of records, and grows the table to that size
+ * @tparam T Type of the stored record
+ * @param numberOfRecords The number of records to always keep room for
+ * @return INVALID_INPUT for a negative number of records, SUCCESS otherwise
+ */
+template<class T, class H>
+StatusType HashTable<T, H>::SetMinimumCapacity(int numberOfRecords) {
+    if (numberOfRecords < 0) {
+        return INVALID_INPUT;
+    }
+    minimumSize = SizeForRecords(numberOfRecords);
+    return Reserve(numberOfRecords);
+}
+
+/**
+ * Draws a new seed for the hash policy and moves every record to it's new
+ * position right away, records still waiting in a draining array are moved
+ * first since they can't be found once the seed changes
+ */
+template<class T, class H>
+void HashTable<T, H>::ReseedAndRehash() {
+    if (oldTable.slots) {
+        MigrateSlots(oldTable.size);
+    }
+    hashFunction.Reseed();
+    reseedsSinceResize++;
+    oldTable = table;
+    migratedIndex = 0;
+    AllocateArray(table, oldTable.size);
+    MigrateSlots(oldTable.size);
+}
+
+template<class T, class H>
+bool HashTable<T, H>::ExtendArray() {
+    Rehash(table.size * 2);
+    reseedsSinceResize = 0;
+    return true;
+}
+
+template<class T, class H>
+bool HashTable<T, H>::ShrinkArray() {
+    Rehash(table.size / 2);
+    reseedsSinceResize = 0;
     return true;
 }
 
-template<class T>
-HashTable<T>::~HashTable() {
-    for (int i = 0; i < size; ++i) {
-        delete hashArray[i];
+template<class T, class H>
+HashTable<T, H>::~HashTable() {
+    if (oldTable.slots) {
+        FreeArray(oldTable);
+    }
+    FreeArray(table);
+}
+
+/**
+ * Removes every record, the table goes back to it's minimum size and the
+ * seed of the hash is kept
+ * @tparam T Type of the stored record
+ */
+template<class T, class H>
+void HashTable<T, H>::Clear() {
+    if (oldTable.slots) {
+        FreeArray(oldTable);
     }
-    delete[] hashArray;
+    FreeArray(table);
+    AllocateArray(table, minimumSize);
+    numberOfItems = 0;
+    migratedIndex = 0;
+    reseedsSinceResize = 0;
+}
+
+template<class T, class H>
+int HashTable<T, H>::getSize() {
+    return table.size;
 }
 
-template<class T>
-int HashTable<T>::getSize() {
-    return size;
+/**
+ * Returns the number of positions a scan of the records with RecordAt visits
+ */
+template<class T, class H>
+int HashTable<T, H>::getNumberOfPositions() {
+    return table.size + (oldTable.slots ? oldTable.size : 0);
 }
 
-template<class T>
-void HashTable<T>::PrintTable() {
-    for (int i = 0; i < size; ++i) {
-        List<T> *listIndex = hashArray[i];
-        ListNode<T> *node = listIndex->ResetIterator();
-        std::cout << "Values at index: " << i << std::endl;
-        while (node) {
-            std::cout << node->getKey() << ", ";
-            node = listIndex->NextIteration();
+/**
+ * Returns the record at a position of a scan over the slot array followed by
+ * the slots of the previous array that were not migrated yet, so every record
+ * is at exactly one position until the next insertion or removal
+ * @tparam T Type of the stored record
+ * @param position A position below getNumberOfPositions()
+ * @return A pointer to the record at the position, nullptr if it holds none
+ */
+template<class T, class H>
+T *HashTable<T, H>::RecordAt(int position) {
+    if (position < table.size) {
+        return table.controlBytes[position] >= 0 ? &table.slots[position].data : nullptr;
+    }
+    position -= table.size;
+    if (position < migratedIndex || oldTable.controlBytes[position] < 0) {
+        return nullptr;
+    }
+    return &oldTable.slots[position].data;
+}
+
+/**
+ * Checks if an incremental resize is still moving records
+ * @return True if an old slot array is still being drained
+ */
+template<class T, class H>
+bool HashTable<T, H>::IsResizing() {
+    return oldTable.slots != nullptr;
+}
+
+template<class T, class H>
+void HashTable<T, H>::PrintTable() {
+    for (int group = 0; group < table.size / groupWidth; ++group) {
+        std::cout << "Values at group: " << group << std::endl;
+        for (int i = group * groupWidth; i < (group + 1) * groupWidth; ++i) {
+            if (table.controlBytes[i] >= 0) {
+                std::cout << table.slots[i].key << ", ";
+            }
+        }
+        std::cout << std::endl;
+    }
+    if (oldTable.slots) {
+        std::cout << "Values waiting for migration: " << std::endl;
+        for (int i = migratedIndex; i < oldTable.size; ++i) {
+            if (oldTable.controlBytes[i] >= 0) {
+                std::cout << oldTable.slots[i].key << ", ";
+            }
         }
         std::cout << std::endl;
     }
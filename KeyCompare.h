@@ -0,0 +1,42 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_KEYCOMPARE_H
+#define WET2_KEYCOMPARE_H
+
+/**
+ * Three way comparison of two keys so a tree decides between the left
+ * subtree, the right subtree and the node itself with one comparison
+ * Keys with a cheaper comparison provide their own CompareKeys overload,
+ * which is preferred over this one
+ * @tparam K The type of the keys, must support operator<
+ * @return A negative number if first < second, a positive number if
+ * second < first and 0 if the keys are equal
+ */
+template<class K>
+inline int CompareKeys(const K &first, const K &second) {
+    return (first < second) ? -1 : (second < first);
+}
+
+/**
+ * Maps an int to an unsigned int with the same order, so packed keys compare
+ * as plain unsigned integers
+ */
+constexpr unsigned int OrderedBits(int value) {
+    return (unsigned int) value ^ 0x80000000u;
+}
+
+constexpr int FromOrderedBits(unsigned int bits) {
+    return (int) (bits ^ 0x80000000u);
+}
+
+/**
+ * @return 1, 0 or -1 if first is greater, equal or smaller than second
+ */
+template<class U>
+constexpr int CompareBits(U first, U second) {
+    return (first > second) - (first < second);
+}
+
+#endif //WET2_KEYCOMPARE_H
@@ -2,18 +2,32 @@
 // Created by Mor on 03/06/2020.
 //
 
+#include <algorithm>
+#include <climits>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "MusicManager.h"
 
-MusicManager::MusicManager() : artistHashTable(HashTable<Artist>()), songRankTree(RankTree<ThreeParamKey, int>()), numberOfSongs(0),
-                               numberOfArtists(0) {
+MusicManager::MusicManager(int minimumNumberOfArtists) : artistIndex(true), songRankTree(&rankingPool),
+                                                     numberOfSongs(0), numberOfArtists(0) {
+    if (minimumNumberOfArtists > 0) {
+        artistIndex.SetMinimumCapacity(minimumNumberOfArtists);
+    }
+#ifdef WET2_AVL_SONG_RANKING
+    // Removed songs stay in the AVL ranking as tombstones until it's compacted,
+    // so a removal never rotates up to the root
+    songRankTree.SetTombstoneMode(true);
+#endif
+}
 
+StatusType MusicManager::Reserve(int numberOfArtists) {
+    return artistIndex.Reserve(numberOfArtists);
 }
 
 StatusType MusicManager::AddArtist(int artistID) {
-    Artist *nArtist = new Artist(artistID);
-    if (artistHashTable.Insert(artistID, nArtist) == FAILURE) {
+    if (artistIndex.Insert(artistID, Artist(artistID, &artistPools)) == FAILURE) {
         // The artist already exist
-        delete nArtist;
         return FAILURE;
     }
     numberOfArtists++;
@@ -21,17 +35,17 @@ StatusType MusicManager::AddArtist(int artistID) {
 }
 
 StatusType MusicManager::RemoveArtist(int artistID) {
-    if (numberOfArtists <= 0 || artistHashTable.FindNode(artistID) == nullptr) {
+    if (numberOfArtists <= 0) {
         return FAILURE;
     }
-    Artist *rArtist = artistHashTable.FindNode(artistID)->getData();
+    Artist *rArtist = artistIndex.FindData(artistID);
     if (rArtist == nullptr || rArtist->getNumberOfSongs() != 0) {
         // The artist doesn't exist or
         // The artist exist but can't be removed because he has songs
         return FAILURE;
     }
 
-    if (artistHashTable.Remove(artistID) != SUCCESS) {
+    if (artistIndex.Remove(artistID) != SUCCESS) {
         return FAILURE;
     }
     numberOfArtists--;
@@ -39,12 +53,15 @@ StatusType MusicManager::RemoveArtist(int artistID) {
 }
 
 StatusType MusicManager::AddSong(int artistID, int songID) {
-    if (numberOfArtists <= 0 || artistHashTable.Find(artistID) != SUCCESS) {
+    if (numberOfArtists <= 0) {
         return FAILURE;
     }
 
-    Artist *artist = artistHashTable.FindNode(artistID)->getData();
-    if (artist->getSongsByIdTree().Find(songID)) {
+    Artist *artist = artistIndex.FindData(artistID);
+    if (!artist) {
+        return FAILURE;
+    }
+    if (artist->HasSong(songID)) {
         return FAILURE;
     }
 
@@ -57,136 +74,238 @@ StatusType MusicManager::AddSong(int artistID, int songID) {
     }
 }
 
+/**
+ * Adds many new songs to an artist, building the artist's trees from the
+ * sorted songs in linear time instead of inserting them one by one
+ * Either all of the songs are added or none of them are
+ * @param songIDs The IDs of the new songs, in any order
+ * @param numberOfNewSongs The number of new songs
+ * @return FAILURE if the artist doesn't exist, a song already exists or a song
+ * appears twice, SUCCESS otherwise
+ */
+StatusType MusicManager::AddSongs(int artistID, const int *songIDs, int numberOfNewSongs) {
+    if (numberOfArtists <= 0) {
+        return FAILURE;
+    }
+
+    Artist *artist = artistIndex.FindData(artistID);
+    if (!artist) {
+        return FAILURE;
+    }
+
+    int *sortedIDs = new int[numberOfNewSongs];
+    std::copy(songIDs, songIDs + numberOfNewSongs, sortedIDs);
+    if (!std::is_sorted(sortedIDs, sortedIDs + numberOfNewSongs)) {
+        std::sort(sortedIDs, sortedIDs + numberOfNewSongs);
+    }
+    for (int i = 0; i < numberOfNewSongs; ++i) {
+        if ((i > 0 && sortedIDs[i] == sortedIDs[i - 1]) || artist->HasSong(sortedIDs[i])) {
+            delete[] sortedIDs;
+            return FAILURE;
+        }
+    }
+
+    artist->AddSongs(sortedIDs, numberOfNewSongs);
+    // The new songs go into the ranking as one batch instead of key by key
+    ThreeParamKey *songKeys = new ThreeParamKey[numberOfNewSongs];
+    for (int i = 0; i < numberOfNewSongs; ++i) {
+        songKeys[i] = ThreeParamKey(0, sortedIDs[i], artistID);
+    }
+    songRankTree.InsertBatch(songKeys, numberOfNewSongs);
+    delete[] songKeys;
+    numberOfSongs += numberOfNewSongs;
+    delete[] sortedIDs;
+    return SUCCESS;
+}
+
+/**
+ * Moves all the songs of one artist to another artist and removes the first
+ * artist, a song both artists have keeps the plays of both
+ * The artists' trees are merged and rebuilt in linear time, and only the
+ * ranking entries whose key changed are replaced, as one batch: the entries of
+ * the moved songs and of the shared songs whose plays changed
+ * @param srcArtistID The artist to move the songs from
+ * @param dstArtistID The artist to move the songs to
+ * @return FAILURE if one of the artists doesn't exist, SUCCESS otherwise
+ */
+StatusType MusicManager::MergeArtists(int srcArtistID, int dstArtistID) {
+    if (numberOfArtists <= 0) {
+        return FAILURE;
+    }
+
+    Artist *source = artistIndex.FindData(srcArtistID);
+    Artist *destination = artistIndex.FindData(dstArtistID);
+    if (!source || !destination) {
+        return FAILURE;
+    }
+
+    int n = source->getNumberOfSongs();
+    int m = destination->getNumberOfSongs();
+    TwoParamKey *sourceKeys = new TwoParamKey[n + 1];
+    TwoParamKey *destinationKeys = new TwoParamKey[m + 1];
+    source->FillSongsByPlays(sourceKeys);
+    destination->FillSongsByPlays(destinationKeys);
+    destination->MergeSongsFrom(*source);
+    int total = destination->getNumberOfSongs();
+    TwoParamKey *mergedKeys = new TwoParamKey[total + 1];
+    destination->FillSongsByPlays(mergedKeys);
+
+    // All of the source's entries go away, the destination's entries change
+    // only where the merged plays order differs from the old one, both orders
+    // are sorted so the differences are found in one pass
+    ThreeParamKey *removedKeys = new ThreeParamKey[n + m + 1];
+    ThreeParamKey *removedDestinationKeys = new ThreeParamKey[m + 1];
+    ThreeParamKey *insertedKeys = new ThreeParamKey[total + 1];
+    int numberOfRemoved = 0;
+    int numberOfInserted = 0;
+    int oldIndex = 0;
+    int mergedIndex = 0;
+    while (oldIndex < m || mergedIndex < total) {
+        if (mergedIndex == total || (oldIndex < m && destinationKeys[oldIndex] < mergedKeys[mergedIndex])) {
+            removedDestinationKeys[numberOfRemoved++] = ThreeParamKey(destinationKeys[oldIndex].getNumberOfPlays(),
+                                                                      destinationKeys[oldIndex].getSongId(),
+                                                                      dstArtistID);
+            oldIndex++;
+        } else if (oldIndex == m || mergedKeys[mergedIndex] < destinationKeys[oldIndex]) {
+            insertedKeys[numberOfInserted++] = ThreeParamKey(mergedKeys[mergedIndex].getNumberOfPlays(),
+                                                             mergedKeys[mergedIndex].getSongId(), dstArtistID);
+            mergedIndex++;
+        } else {
+            oldIndex++;
+            mergedIndex++;
+        }
+    }
+    ThreeParamKey *removedSourceKeys = new ThreeParamKey[n + 1];
+    for (int i = 0; i < n; ++i) {
+        removedSourceKeys[i] = ThreeParamKey(sourceKeys[i].getNumberOfPlays(), sourceKeys[i].getSongId(), srcArtistID);
+    }
+    std::merge(removedSourceKeys, removedSourceKeys + n, removedDestinationKeys,
+               removedDestinationKeys + numberOfRemoved, removedKeys);
+    numberOfRemoved += n;
+    songRankTree.ReplaceKeys(removedKeys, numberOfRemoved, insertedKeys, numberOfInserted);
+    numberOfSongs -= n + m - total;
+
+    delete[] sourceKeys;
+    delete[] destinationKeys;
+    delete[] mergedKeys;
+    delete[] removedKeys;
+    delete[] removedDestinationKeys;
+    delete[] removedSourceKeys;
+    delete[] insertedKeys;
+
+    if (artistIndex.Remove(srcArtistID) != SUCCESS) {
+        return FAILURE;
+    }
+    numberOfArtists--;
+    return SUCCESS;
+}
+
 StatusType MusicManager::RemoveSong(int artistID, int songID) {
-    if (numberOfArtists <= 0 || artistHashTable.Find(artistID) != SUCCESS) {
+    if (numberOfArtists <= 0) {
         return FAILURE;
     }
 
-    Artist *artist = artistHashTable.FindNode(artistID)->getData();
-    TreeNode<Song> *songNode = artist->getSongsByIdTree().Find(songID);
-    if (!songNode) {
+    Artist *artist = artistIndex.FindData(artistID);
+    if (!artist) {
+        return FAILURE;
+    }
+    int numberOfPlays = artist->RemoveSong(songID);
+    if (numberOfPlays < 0) {
         // The song doesn't exist
         return FAILURE;
     }
 
-    Song *song = songNode->getData();
-    ThreeParamKey songKey = ThreeParamKey(song->getNumberOfPlays(), songID, artistID);
+    ThreeParamKey songKey = ThreeParamKey(numberOfPlays, songID, artistID);
     songRankTree.Remove(songKey);
 //    songRankTree.RankSanityCheck();
+    numberOfSongs--;
+    return SUCCESS;
+}
 
-//    Song *bestSong = artist->getBestSong();
-//    TwoParamKey songTwoKey = TwoParamKey(bestSong->getNumberOfPlays(), songID);
-//    if (bestSong->getSongId() == songID) {
-//        if (artist->getNumberOfSongs() <= 2) {
-//            // The tree has either 1 or two nodes
-//            if (artist->getNumberOfSongs() == 1) {
-//                // The song we are deleting was the only song for this artist, marking best song as empty
-//                artist->setBestSong(nullptr);
-//            } else {
-//                RankTreeNode<TwoParamKey, Song> *bestSongFromPlaysNode = artist->getSongsByPlaysTree().Find(songTwoKey);
-//                if (bestSongFromPlaysNode->getLeft()) {
-//                    // The best song is currently the root of the tree, setting the new best song to be his left son
-//                    // (will be fixed after rotations)
-//                    artist->setBestSong(bestSongFromPlaysNode->getLeft()->getData());
-//                } else {
-//                    // The best song is currently the right child of the root, setting the new best song to be his root.
-//                    artist->setBestSong(bestSongFromPlaysNode->getParent()->getData());
-//                }
-//            }
-//        } else {
-//            // The artist has other songs so now a new song needs to be marked as the artists' best song
-//            RankTreeNode<TwoParamKey, Song> *bestSongFromPlaysNode = artist->getSongsByPlaysTree().Find(songTwoKey);
-//            artist->setBestSong(bestSongFromPlaysNode->getParent()->getData());
-//        }
-//    }
-
-    TwoParamKey removedSongKey = TwoParamKey(song->getNumberOfPlays(), songID);
-    artist->getSongsByIdTree().Remove(songID);
-    artist->getSongsByPlaysTree().Remove(removedSongKey);
-    if (artist->getNumberOfSongs() == 1) {
-        artist->setBestSong(nullptr);
-    } else {
-        artist->setBestSong(artist->getSongsByPlaysTree().GetRoot()->findMaxNoRank()->getData());
+/**
+ * Removes every song with fewer plays than the input number from all artists
+ * The songs are the lowest range of the ranking, which is cut out of it in
+ * O(log n + k) for k removed songs, and every artist with songs in the range
+ * cuts them out of it's plays order the same way, once
+ * @param numberOfPlays The minimal number of plays of a kept song
+ * @return SUCCESS
+ */
+StatusType MusicManager::RemoveSongsWithPlaysBelow(int numberOfPlays) {
+    // Among songs with the same plays higher IDs are smaller keys
+    SongRanking removed = songRankTree.ExtractRange(ThreeParamKey(INT_MIN, INT_MAX, INT_MAX),
+                                                    ThreeParamKey(numberOfPlays, INT_MAX, INT_MAX));
+    for (const ThreeParamKey &key : removed) {
+        // An artist removes all of it's songs in the range the first time
+        // one of them is reached, and is marked so it's other songs in the
+        // range don't search it's plays order again
+        Artist *artist = artistIndex.FindData(key.getArtistId());
+        if (artist && !artist->IsPurged()) {
+            numberOfSongs -= artist->RemoveSongsWithPlaysBelow(numberOfPlays);
+            artist->setPurged(true);
+        }
+    }
+    for (const ThreeParamKey &key : removed) {
+        Artist *artist = artistIndex.FindData(key.getArtistId());
+        if (artist) {
+            artist->setPurged(false);
+        }
     }
-    int oldNumberOfSongsForArtist = artist->getNumberOfSongs();
-    artist->setNumberOfSongs(oldNumberOfSongsForArtist - 1);
-    numberOfSongs--;
     return SUCCESS;
 }
 
 StatusType MusicManager::AddToSongCount(int artistID, int songID, int count) {
-    if (numberOfArtists <= 0 || artistHashTable.Find(artistID) != SUCCESS) {
+    if (numberOfArtists <= 0) {
         return FAILURE;
     }
 
-    Artist *artist = artistHashTable.FindNode(artistID)->getData();
-    //artist->compareNumberOfSongs();
-    TreeNode<Song> *songNode = artist->getSongsByIdTree().Find(songID);
-    if (!songNode) {
-        // The song doesn't exist
+    Artist *artist = artistIndex.FindData(artistID);
+    if (!artist) {
         return FAILURE;
     }
+    //artist->compareNumberOfSongs();
+    return AddToFoundSongCount(artistID, songID, count, artist, nullptr);
+}
 
-    Song *songFromId = songNode->getData();
-    int oldNumberOfPlays = songFromId->getNumberOfPlays();
-    int newNumberOfPlays = oldNumberOfPlays + count;
-//    bool isBesPtrReplaced = false;
-//    Song *currentBest = artist->getBestSong();
-//
-//    if (currentBest->getSongId() != songID) {
-//        if (currentBest->getNumberOfPlays() < newNumberOfPlays) {
-//            isBesPtrReplaced = true;
-//        } else if (currentBest->getNumberOfPlays() == newNumberOfPlays && currentBest->getSongId() > songID) {
-//            isBesPtrReplaced = true;
-//        }
-//    } else if (currentBest->getSongId() == songID) {
-//        isBesPtrReplaced = true;
-//    }
-
-    songFromId->setNumberOfPlays(newNumberOfPlays);
-    TwoParamKey oldTwoKey = TwoParamKey(oldNumberOfPlays, songID);
-    artist->getSongsByPlaysTree().Remove(oldTwoKey);
-    TwoParamKey newTwoKey = TwoParamKey(newNumberOfPlays, songID);
-    Song *nSongPlays = new Song(songID, artistID, newNumberOfPlays, nullptr);
-    if (!nSongPlays) {
-        songFromId->setNumberOfPlays(oldNumberOfPlays);
-        return ALLOCATION_ERROR;
-    }
-    artist->getSongsByPlaysTree().Insert(newTwoKey, nSongPlays);
-    if (!artist->getSongsByPlaysTree().Find(newTwoKey)) {
-        songFromId->setNumberOfPlays(oldNumberOfPlays);
-        delete nSongPlays;
-        return ALLOCATION_ERROR;
+/**
+ * Adds to the play count of a song of an artist that was already looked up,
+ * updating the artist's songs and the global ranking
+ * @param artist The artist of the song
+ * @param songFromId The song as stored in the artist's songs by ID tree if it
+ * was already looked up, nullptr otherwise
+ * @return FAILURE if the song doesn't exist, SUCCESS otherwise
+ */
+StatusType MusicManager::AddToFoundSongCount(int artistID, int songID, int count, Artist *artist, Song *songFromId) {
+    int oldNumberOfPlays = artist->AddToSongCount(songID, count, songFromId);
+    if (oldNumberOfPlays < 0) {
+        // The song doesn't exist
+        return FAILURE;
     }
-//    if (isBesPtrReplaced) {
-//        artist->setBestSong(nSongPlays);
-//    }
-
-    artist->setBestSong(artist->getSongsByPlaysTree().GetRoot()->findMaxNoRank()->getData());
 
 //    songRankTree.RankSanityCheck();
     ThreeParamKey oldThreeKey = ThreeParamKey(oldNumberOfPlays, songID, artistID);
     songRankTree.Remove(oldThreeKey);
-    ThreeParamKey newThreeKey = ThreeParamKey(newNumberOfPlays, songID, artistID);
+    ThreeParamKey newThreeKey = ThreeParamKey(oldNumberOfPlays + count, songID, artistID);
     songRankTree.Insert(newThreeKey);
 //    songRankTree.RankSanityCheck();
-    //artist->compareNumberOfSongs();
     return SUCCESS;
 }
 
 StatusType MusicManager::GetArtistBestSong(int artistID, int *songID) {
-    if (numberOfArtists <= 0 || artistHashTable.Find(artistID) != SUCCESS) {
+    if (numberOfArtists <= 0) {
+        return FAILURE;
+    }
+
+    Artist *artist = artistIndex.FindData(artistID);
+    if (!artist) {
         return FAILURE;
     }
-    
-    Artist *artist = artistHashTable.FindNode(artistID)->getData();
     if (artist->getNumberOfSongs() == 0) {
         return FAILURE;
     }
 
 //    RankTreeNode<TwoParamKey, Song> *foundMax = artist->getSongsByPlaysTree().GetRoot()->findMaxNoRank();
 //    *songID = foundMax->getData()->getSongId();
-    *songID = artist->getBestSong()->getSongId();
+    *songID = artist->getBestSongId();
     return SUCCESS;
 }
 
@@ -202,62 +321,240 @@ StatusType MusicManager::GetRecommendedSongInPlace(int rank, int *artistID, int
     return SUCCESS;
 }
 
-StatusType MusicManager::AddSongToArtist(int artistID, int songID, Artist *artist) {
-    Song *nSong = new Song(songID, artistID, 0, nullptr);
-    if (!nSong) {
-        return ALLOCATION_ERROR;
-    }
-    artist->getSongsByIdTree().Insert(songID, nSong);
-    if (!artist->getSongsByIdTree().Find(songID)) {
-        delete nSong;
-        return ALLOCATION_ERROR;
+/**
+ * Looks up the artists and the songs of a group of operations with their
+ * memory accesses interleaved, every stage issues prefetches for the whole
+ * group before any of them is dereferenced, and the songs by ID trees are
+ * descended one node per operation per round
+ * @param numberOfOperations The size of the group, at most batchGroupSize
+ * @param artists Filled with the artist of every operation, nullptr if missing
+ * @param songs Filled with the song of every operation, nullptr if missing
+ */
+void MusicManager::FindSongsInterleaved(int numberOfOperations, const int *artistIDs, const int *songIDs,
+                                        Artist **artists, Song **songs) {
+    BTreeNode<Song, LibraryNodeStorage> *songNodes[batchGroupSize];
+    for (int i = 0; i < numberOfOperations; ++i) {
+        artistIndex.Prefetch(artistIDs[i]);
     }
-    Song *nSongPlays = new Song(songID, artistID, 0, nullptr);
-    if (!nSongPlays) {
-        artist->getSongsByIdTree().Remove(songID);
-        return ALLOCATION_ERROR;
+    for (int i = 0; i < numberOfOperations; ++i) {
+        artists[i] = artistIndex.FindData(artistIDs[i]);
+        songs[i] = nullptr;
+        // Small artists find their songs with a scan of the inline arrays
+        songNodes[i] = artists[i] && !artists[i]->IsSmall() ? artists[i]->getSongsByIdTree().GetRoot() : nullptr;
+        if (songNodes[i]) {
+            songNodes[i]->Prefetch();
+        }
     }
-    TwoParamKey songKey = TwoParamKey(0, songID);
-    artist->getSongsByPlaysTree().Insert(songKey, nSongPlays);
-    if (!artist->getSongsByPlaysTree().Find(songKey)) {
-        delete nSongPlays;
-        artist->getSongsByIdTree().Remove(songID);
-        return ALLOCATION_ERROR;
+    bool isDescending = true;
+    while (isDescending) {
+        isDescending = false;
+        for (int i = 0; i < numberOfOperations; ++i) {
+            BTreeNode<Song, LibraryNodeStorage> *node = songNodes[i];
+            if (!node) {
+                // This operation already found it's song or the song doesn't exist
+                continue;
+            }
+            int position = node->LowerBound(songIDs[i]);
+            if (position < node->getNumberOfKeys() && node->getKey(position) == songIDs[i]) {
+                songs[i] = node->getData(position);
+                node = nullptr;
+            } else if (node->IsLeaf()) {
+                node = nullptr;
+            } else {
+                node = node->getChild(position);
+                node->Prefetch();
+                isDescending = true;
+            }
+            songNodes[i] = node;
+        }
     }
+}
 
-    if (artist->getNumberOfSongs() == 0) {
-        // This is the first song of the artist, so it is also it's best song.
-        artist->setBestSong(nSongPlays);
-    } else {
-        artist->setBestSong(artist->getSongsByPlaysTree().GetRoot()->findMaxNoRank()->getData());
-//        Song *oldBest = artist->getBestSong();
-//        if (oldBest->getNumberOfPlays() == 0 && oldBest->getSongId() > songID) {
-//            // The old best song has 0 plays just like the one we added, so according
-//            // to printing rules we need to set the new one as the best song.
-//            artist->setBestSong(nSongPlays);
-//        }
-    }
-
-    if (AddSongToRankTree(artistID, songID, nSong) == ALLOCATION_ERROR) {
-        artist->getSongsByIdTree().Remove(songID);
-        artist->getSongsByPlaysTree().Remove(songKey);
-        return ALLOCATION_ERROR;
+/**
+ * Runs many AddToSongCount operations, overlapping the memory latency of their
+ * artist and song lookups
+ * AddToSongCount never changes the artist index or the songs by ID trees, so
+ * the lookups of a group can all be done before the updates of the group,
+ * the results are the same as calling AddToSongCount for every operation in order
+ * @param numberOfOperations The number of operations
+ * @param results Filled with the result of every operation
+ * @return SUCCESS after all operations were executed
+ */
+StatusType MusicManager::AddToSongCountBatch(int numberOfOperations, const int *artistIDs, const int *songIDs,
+                                             const int *counts, StatusType *results) {
+    Artist *artists[batchGroupSize];
+    Song *songs[batchGroupSize];
+    for (int groupStart = 0; groupStart < numberOfOperations; groupStart += batchGroupSize) {
+        int groupSize = std::min(batchGroupSize, numberOfOperations - groupStart);
+        FindSongsInterleaved(groupSize, artistIDs + groupStart, songIDs + groupStart, artists, songs);
+        for (int i = 0; i < groupSize; ++i) {
+            int operation = groupStart + i;
+            if (artistIDs[operation] <= 0 || songIDs[operation] <= 0 || counts[operation] <= 0) {
+                results[operation] = INVALID_INPUT;
+            } else if (numberOfArtists <= 0 || !artists[i] || (!artists[i]->IsSmall() && !songs[i])) {
+                results[operation] = FAILURE;
+            } else {
+                results[operation] = AddToFoundSongCount(artistIDs[operation], songIDs[operation], counts[operation],
+                                                         artists[i], songs[i]);
+            }
+        }
     }
+    return SUCCESS;
+}
 
-    int currentNumberOfSongs = artist->getNumberOfSongs();
-    artist->setNumberOfSongs(currentNumberOfSongs + 1);
-
+/**
+ * Runs many GetArtistBestSong operations, overlapping the memory latency of
+ * their artist lookups
+ * @param numberOfOperations The number of operations
+ * @param songIDs Filled with the best song of every successful operation
+ * @param results Filled with the result of every operation
+ * @return SUCCESS after all operations were executed
+ */
+StatusType MusicManager::GetArtistBestSongBatch(int numberOfOperations, const int *artistIDs, int *songIDs,
+                                                StatusType *results) {
+    Artist *artists[batchGroupSize];
+    for (int groupStart = 0; groupStart < numberOfOperations; groupStart += batchGroupSize) {
+        int groupSize = std::min(batchGroupSize, numberOfOperations - groupStart);
+        for (int i = 0; i < groupSize; ++i) {
+            artistIndex.Prefetch(artistIDs[groupStart + i]);
+        }
+        for (int i = 0; i < groupSize; ++i) {
+            int operation = groupStart + i;
+            artists[i] = artistIndex.FindData(artistIDs[operation]);
+            if (artistIDs[operation] <= 0) {
+                results[operation] = INVALID_INPUT;
+            } else if (numberOfArtists <= 0 || !artists[i] || artists[i]->getNumberOfSongs() == 0) {
+                results[operation] = FAILURE;
+            } else {
+                songIDs[operation] = artists[i]->getBestSongId();
+                results[operation] = SUCCESS;
+            }
+        }
+    }
     return SUCCESS;
 }
 
-StatusType MusicManager::AddSongToRankTree(int artistID, int songID, Song *nSong) {
+StatusType MusicManager::AddSongToArtist(int artistID, int songID, Artist *artist) {
+    artist->AddSong(songID);
+    return AddSongToRankTree(artistID, songID);
+}
+
+StatusType MusicManager::AddSongToRankTree(int artistID, int songID) {
     ThreeParamKey songKey = ThreeParamKey(0, songID, artistID);
     songRankTree.Insert(songKey, nullptr);
 //    songRankTree.RankSanityCheck();
-    RankTreeNode<ThreeParamKey, int> *nRankedSong = songRankTree.Find(songKey);
-    if (!nRankedSong) {
+    return SUCCESS;
+}
+/**
+ * Runs a slice of a pass that moves the songs and the tree nodes to the lowest
+ * free slots of their arenas, so after heavy removals the surviving nodes are
+ * packed in dense in order runs and the chunks left empty are released
+ * The first slice opens the pass, which walks the global ranking and then
+ * every artist, and any operation may run between two slices
+ * A pass that was open when an artist moved in the index may skip some of
+ * it's nodes, they are packed by the next pass
+ * @param budget The number of keys and artist index positions the slice may
+ * visit
+ * @param isDone Set to true if this slice finished the pass
+ * @return ALLOCATION_ERROR if opening or closing the pass ran out of memory,
+ * SUCCESS otherwise
+ */
+StatusType MusicManager::CompactNodes(int budget, bool *isDone) {
+    *isDone = false;
+    try {
+        if (!isRelocating) {
+            rankingPool.BeginRelocation();
+            artistPools.BeginRelocation();
+            isRelocating = true;
+            isRankingRelocated = false;
+            // A pass dropped by Reset may have left the cursor mid ranking
+            rankingCursor = RelocationCursor<ThreeParamKey>();
+            relocationPosition = 0;
+            relocationArtistID = 0;
+        }
+        if (!isRankingRelocated) {
+            if (!songRankTree.RelocateNodes(rankingCursor, budget)) {
+                return SUCCESS;
+            }
+            isRankingRelocated = true;
+        }
+        while (relocationPosition < artistIndex.getNumberOfPositions()) {
+            if (budget <= 0) {
+                return SUCCESS;
+            }
+            budget--;
+            Artist *artist = artistIndex.RecordAt(relocationPosition);
+            if (artist && artist->getArtistId() != relocationArtistID) {
+                // The cursors may belong to an artist that moved or was removed
+                // since the last slice
+                songsByIdCursor = RelocationCursor<int>();
+                songsByPlaysCursor = RelocationCursor<TwoParamKey>();
+                relocationArtistID = artist->getArtistId();
+            }
+            if (artist && !artist->RelocateNodes(songsByIdCursor, songsByPlaysCursor, budget)) {
+                return SUCCESS;
+            }
+            relocationPosition++;
+        }
+        rankingPool.EndRelocation();
+        artistPools.EndRelocation();
+        isRelocating = false;
+        *isDone = true;
+        return SUCCESS;
+    } catch (std::bad_alloc &e) {
+        return ALLOCATION_ERROR;
+    }
+}
+
+/**
+ * Ends any open relocation pass and, when it's safe, frees every song and
+ * tree node of the library at once instead of deleting them one by one
+ * That needs arenas and songs that own nothing, otherwise the trees are left
+ * to be deleted node by node, the arenas belong to this instance alone
+ * The global ranking only stores keys, so it's data owns nothing either
+ */
+void MusicManager::ReleaseNodes() {
+    if (isRelocating) {
+        rankingPool.EndRelocation();
+        artistPools.EndRelocation();
+        isRelocating = false;
+    }
+    if (!LibraryNodeStorage::canReleaseAll || !std::is_trivially_destructible<Song>::value) {
+        return;
+    }
+    for (int position = 0; position < artistIndex.getNumberOfPositions(); ++position) {
+        Artist *artist = artistIndex.RecordAt(position);
+        if (artist) {
+            artist->MarkTreesAsNullptr();
+        }
+    }
+    songRankTree.MarkRootAsNullptr();
+    rankingPool.Clear();
+    artistPools.Clear();
+}
+
+/**
+ * Removes every artist and song, leaving an empty library that keeps it's
+ * minimum number of artists, so the same instance can be used again
+ * @return ALLOCATION_ERROR if the artist index couldn't be rebuilt, SUCCESS
+ * otherwise
+ */
+StatusType MusicManager::Reset() {
+    ReleaseNodes();
+    {
+        // Moving the ranking out deletes any nodes left and keeps it's mode
+        SongRanking removed(std::move(songRankTree));
+    }
+    numberOfSongs = 0;
+    numberOfArtists = 0;
+    try {
+        artistIndex.Clear();
+    } catch (std::bad_alloc &e) {
         return ALLOCATION_ERROR;
     }
-    nSong->setPtrToRankedSong(nRankedSong);
     return SUCCESS;
-}
\ No newline at end of file
+}
+
+MusicManager::~MusicManager() {
+    ReleaseNodes();
+}
@@ -7,19 +7,55 @@
 
 
 #include "library2.h"
-#include "HashTable.h"
+#include "AdaptiveIndex.h"
 #include "Artist.h"
 #include "RankTree.h"
+#include "CountedBPlusTree.h"
 #include "ThreeParamKey.h"
 
+/**
+ * Number of operations whose lookups are interleaved by the batch functions
+ */
+const int batchGroupSize = 16;
+
+/**
+ * The global ranking of the songs, an order statistic B+tree unless the AVL
+ * RankTree is selected with WET2_AVL_SONG_RANKING
+ * The ranking only needs the keys, so either tree is a key-only set
+ */
+#ifdef WET2_AVL_SONG_RANKING
+typedef RankTree<ThreeParamKey, void, AvlBalance, LibraryNodeStorage> SongRanking;
+#else
+typedef CountedBPlusTree<ThreeParamKey, void, LibraryNodeStorage> SongRanking;
+#endif
+
 class MusicManager {
 private:
-    HashTable<Artist> artistHashTable;
-    RankTree<ThreeParamKey, int> songRankTree;
+    // The pools are declared first, so they outlive every node allocated from
+    // them
+    ArtistPools artistPools;
+    SongRanking::NodePool rankingPool;
+    AdaptiveIndex<Artist> artistIndex;
+    SongRanking songRankTree;
     int numberOfSongs;
     int numberOfArtists;
+    bool isRelocating = false;
+    bool isRankingRelocated = false;
+    int relocationPosition = 0;
+    int relocationArtistID = 0;
+    RelocationCursor<ThreeParamKey> rankingCursor;
+    RelocationCursor<int> songsByIdCursor;
+    RelocationCursor<TwoParamKey> songsByPlaysCursor;
+
+    void ReleaseNodes();
+
+    void FindSongsInterleaved(int numberOfOperations, const int *artistIDs, const int *songIDs, Artist **artists,
+                              Song **songs);
+
 public:
-    MusicManager();
+    explicit MusicManager(int minimumNumberOfArtists = 0);
+
+    StatusType Reserve(int numberOfArtists);
 
     StatusType AddArtist(int artistID);
 
@@ -27,19 +63,36 @@ public:
 
     StatusType AddSong(int artistID, int songID);
 
+    StatusType AddSongs(int artistID, const int *songIDs, int numberOfNewSongs);
+
     StatusType RemoveSong(int artistID, int songID);
 
+    StatusType MergeArtists(int srcArtistID, int dstArtistID);
+
+    StatusType RemoveSongsWithPlaysBelow(int numberOfPlays);
+
     StatusType AddToSongCount(int artistID, int songID, int count);
 
     StatusType GetArtistBestSong(int artistID, int *songID);
 
     StatusType GetRecommendedSongInPlace(int rank, int *artistID, int *songID);
 
-    ~MusicManager() = default;
+    StatusType AddToSongCountBatch(int numberOfOperations, const int *artistIDs, const int *songIDs, const int *counts,
+                                   StatusType *results);
+
+    StatusType GetArtistBestSongBatch(int numberOfOperations, const int *artistIDs, int *songIDs, StatusType *results);
+
+    StatusType CompactNodes(int budget, bool *isDone);
+
+    StatusType Reset();
+
+    ~MusicManager();
 
     StatusType AddSongToArtist(int artistID, int songID, Artist *artist);
 
-    StatusType AddSongToRankTree(int artistID, int songID, Song *nSong);
+    StatusType AddToFoundSongCount(int artistID, int songID, int count, Artist *artist, Song *songFromId);
+
+    StatusType AddSongToRankTree(int artistID, int songID);
 };
 
 
@@ -0,0 +1,464 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+#ifndef WET2_NODESTORAGE_H
+#define WET2_NODESTORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+ * Storage policies for the trees and lists, which allocate their nodes
+ * through them
+ * A policy decides where the nodes live and how a node links to it's
+ * neighbours, the tree code is the same for every policy:
+ * Pool<N> is where nodes of type N are allocated, every structure gets a
+ * pointer to the pool it allocates from and structures that never share
+ * nodes may use different pools, so two owners of pools share no state
+ * NodeBase<N> is a base class of the node which replaces operator new, a node
+ * is created with new (pool) N(...) and deleted with a plain delete, any other
+ * type allocated often (like the data of the nodes) may derive from it too
+ * PoolOf<N> finds the pool a node was allocated from
+ * Link<N> is the type of a link to a node, it is built from a N* or nullptr
+ * and converts back to a N*, a link must be stored inside a node of the same
+ * pool as the node it links to
+ * The B-trees only allocate their wide nodes through the policy and keep
+ * pointers between them
+ * A pool has BeginRelocation, EndRelocation and Clear, Relocate<N> may move a
+ * node to a lower address during a relocation pass of it's pool, the caller
+ * fixes every link to the node
+ * If canReleaseAll is true Clear frees every node of the pool at once without
+ * running destructors, after every structure holding such nodes has forgotten
+ * them
+ */
+
+/**
+ * The position of a relocation pass over one tree, the pass resumes at the
+ * first key not smaller than nextKey so the tree may change between slices
+ * @tparam K Class for node key comparisons, must be default constructible
+ */
+template<class K>
+struct RelocationCursor {
+    K nextKey = K();
+    bool isStarted = false;
+};
+
+/**
+ * Every node is allocated on it's own with new and linked by pointers
+ */
+struct PointerStorage {
+    template<class N>
+    using Link = N *;
+
+    /**
+     * The nodes come from the global heap, so the pool holds nothing
+     */
+    template<class N>
+    struct Pool {
+        void BeginRelocation() {}
+
+        void EndRelocation() {}
+
+        void Clear() {}
+    };
+
+    template<class N>
+    struct NodeBase {
+        static void *operator new(size_t size, Pool<N> *) {
+            return ::operator new(size);
+        }
+
+        static void operator delete(void *node, Pool<N> *) {
+            ::operator delete(node);
+        }
+
+        static void operator delete(void *node) {
+            ::operator delete(node);
+        }
+    };
+
+    template<class N>
+    static Pool<N> *PoolOf(const N *) {
+        return nullptr;
+    }
+
+    template<class N>
+    static N *Relocate(N *node) {
+        return node;
+    }
+
+    static const bool canReleaseAll = false;
+};
+
+/**
+ * @return The base 2 logarithm of a positive value, rounded down
+ */
+constexpr unsigned int ArenaFloorLog2(size_t value) {
+    return value > 1 ? 1 + ArenaFloorLog2(value / 2) : 0;
+}
+
+/**
+ * A chunked arena holding all the nodes of one type
+ * A node is addressed by a 32 bit index, the chunks never move so a node
+ * keeps it's address for as long as it lives, freed slots are reused first
+ * Each chunk is aligned to chunkBytes and starts with the index of it's first
+ * slot and a pointer to the arena, so the index and the arena of a node are
+ * found from it's address without a lookup
+ * A chunk holds a power of two number of slots, so finding a node by index is
+ * a shift and a mask
+ * Index 0 is never handed out and stands for nullptr
+ * During a relocation pass the free list is sorted so Relocate moves nodes to
+ * the lowest free slots, and freed slots wait on a separate list until the
+ * pass ends, the end of the pass sorts all the free slots again and releases
+ * the chunks left empty past the last node
+ * @tparam N The type of the nodes
+ */
+template<class N>
+class NodeArena {
+private:
+    struct ChunkHeader {
+        unsigned int firstIndex;
+        NodeArena<N> *arena;
+    };
+
+    static const size_t chunkBytes = size_t(1) << 20;
+    static const size_t slotsOffset = (sizeof(ChunkHeader) + alignof(N) - 1) / alignof(N) * alignof(N);
+    static const unsigned int slotShift = ArenaFloorLog2((chunkBytes - slotsOffset) / sizeof(N));
+    static const unsigned int slotsPerChunk = 1u << slotShift;
+    static const unsigned int slotMask = slotsPerChunk - 1;
+    static const size_t usedChunkBytes = slotsOffset + slotsPerChunk * sizeof(N);
+
+    static_assert(sizeof(N) >= sizeof(unsigned int), "A free slot holds the index of the next free slot");
+    static_assert(usedChunkBytes <= chunkBytes, "A chunk must fit at least one node");
+
+    char **chunks = nullptr;
+    unsigned int numberOfChunks = 0;
+    unsigned int chunksCapacity = 0;
+    unsigned int nextIndex = 1;
+    unsigned int freeIndex = 0;
+    unsigned int numberOfNodes = 0;
+    bool isRelocating = false;
+    unsigned int retiredIndex = 0;
+
+    static N *SlotInChunk(char *chunk, unsigned int slot) {
+        return reinterpret_cast<N *>(chunk + slotsOffset + slot * sizeof(N));
+    }
+
+    void AddChunk();
+
+    void SortFreeSlots();
+
+    static const ChunkHeader *HeaderOf(const void *address) {
+        std::uintptr_t chunk = reinterpret_cast<std::uintptr_t>(address) & ~(std::uintptr_t) (chunkBytes - 1);
+        return reinterpret_cast<const ChunkHeader *>(chunk);
+    }
+
+public:
+    NodeArena() = default;
+
+    NodeArena(const NodeArena<N> &other) = delete;
+
+    NodeArena<N> &operator=(const NodeArena<N> &other) = delete;
+
+    ~NodeArena();
+
+    void *Allocate();
+
+    void Free(void *node);
+
+    void BeginRelocation();
+
+    N *Relocate(N *node);
+
+    void EndRelocation();
+
+    void Clear();
+
+    N *getNode(unsigned int index) const {
+        return index ? SlotInChunk(chunks[index >> slotShift], index & slotMask) : nullptr;
+    }
+
+    static unsigned int getIndex(const N *node) {
+        if (!node) {
+            return 0;
+        }
+        const ChunkHeader *header = HeaderOf(node);
+        std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(node) - reinterpret_cast<std::uintptr_t>(header);
+        return header->firstIndex + (unsigned int) ((offset - slotsOffset) / sizeof(N));
+    }
+
+    /**
+     * @param address An address inside a chunk of some arena of this type,
+     * like the address of a node or of a link stored in a node
+     * @return The arena owning the chunk
+     */
+    static NodeArena<N> *ArenaOf(const void *address) {
+        return HeaderOf(address)->arena;
+    }
+
+    unsigned int getNumberOfNodes() const {
+        return numberOfNodes;
+    }
+};
+
+template<class N>
+NodeArena<N>::~NodeArena() {
+    for (unsigned int i = 0; i < numberOfChunks; ++i) {
+        std::free(chunks[i]);
+    }
+    delete[] chunks;
+}
+
+/**
+ * Adds an empty chunk after the last one, growing the array of chunks if it
+ * is full
+ */
+template<class N>
+void NodeArena<N>::AddChunk() {
+    if (numberOfChunks == chunksCapacity) {
+        chunksCapacity = chunksCapacity ? 2 * chunksCapacity : 16;
+        char **newChunks = new char *[chunksCapacity];
+        for (unsigned int i = 0; i < numberOfChunks; ++i) {
+            newChunks[i] = chunks[i];
+        }
+        delete[] chunks;
+        chunks = newChunks;
+    }
+    void *chunk = nullptr;
+    // Only the slots are allocated, the alignment keeps the header lookup valid
+    if (posix_memalign(&chunk, chunkBytes, usedChunkBytes) != 0) {
+        throw std::bad_alloc();
+    }
+    reinterpret_cast<ChunkHeader *>(chunk)->firstIndex = numberOfChunks << slotShift;
+    reinterpret_cast<ChunkHeader *>(chunk)->arena = this;
+    chunks[numberOfChunks++] = static_cast<char *>(chunk);
+}
+
+/**
+ * @return Uninitialized memory for one node, a freed slot if there is one
+ * and the next unused slot otherwise
+ */
+template<class N>
+void *NodeArena<N>::Allocate() {
+    numberOfNodes++;
+    if (freeIndex) {
+        // A free slot holds the index of the next free slot
+        N *node = getNode(freeIndex);
+        freeIndex = *reinterpret_cast<unsigned int *>(node);
+        return node;
+    }
+    if (retiredIndex) {
+        N *node = getNode(retiredIndex);
+        retiredIndex = *reinterpret_cast<unsigned int *>(node);
+        return node;
+    }
+    if (nextIndex >= numberOfChunks << slotShift) {
+        AddChunk();
+    }
+    return getNode(nextIndex++);
+}
+
+template<class N>
+void NodeArena<N>::Free(void *node) {
+    if (!node) {
+        return;
+    }
+    numberOfNodes--;
+    if (isRelocating) {
+        // A slot freed during a pass would break the order of the free list
+        *static_cast<unsigned int *>(node) = retiredIndex;
+        retiredIndex = getIndex(static_cast<N *>(node));
+        return;
+    }
+    *static_cast<unsigned int *>(node) = freeIndex;
+    freeIndex = getIndex(static_cast<N *>(node));
+}
+
+/**
+ * Rebuilds the free list from the free and retired slots in ascending index
+ * order, the free slots at the end of the used slots are dropped and the
+ * chunks they leave empty are released
+ * Takes O(number of slots) and allocates one byte per slot
+ */
+template<class N>
+void NodeArena<N>::SortFreeSlots() {
+    unsigned char *isFree = new unsigned char[nextIndex];
+    memset(isFree, 0, nextIndex);
+    for (unsigned int index = freeIndex; index; index = *reinterpret_cast<unsigned int *>(getNode(index))) {
+        isFree[index] = 1;
+    }
+    for (unsigned int index = retiredIndex; index; index = *reinterpret_cast<unsigned int *>(getNode(index))) {
+        isFree[index] = 1;
+    }
+    while (nextIndex > 1 && isFree[nextIndex - 1]) {
+        nextIndex--;
+    }
+    // Linking from the back leaves the lowest slot at the head of the list
+    freeIndex = 0;
+    retiredIndex = 0;
+    for (unsigned int index = nextIndex - 1; index > 0; --index) {
+        if (isFree[index]) {
+            *reinterpret_cast<unsigned int *>(getNode(index)) = freeIndex;
+            freeIndex = index;
+        }
+    }
+    delete[] isFree;
+    unsigned int usedChunks = (nextIndex + slotMask) >> slotShift;
+    while (numberOfChunks > usedChunks) {
+        std::free(chunks[--numberOfChunks]);
+    }
+}
+
+/**
+ * Opens a relocation pass, opening a pass that is already open does nothing
+ */
+template<class N>
+void NodeArena<N>::BeginRelocation() {
+    if (isRelocating) {
+        return;
+    }
+    SortFreeSlots();
+    isRelocating = true;
+}
+
+/**
+ * Moves a node to the lowest free slot if that slot comes before the node,
+ * the node is copied byte by byte so it must not point into itself
+ * The old slot can't be reused until the pass ends
+ * @param node A node of this arena
+ * @return The new address of the node, or it's old one if it didn't move
+ */
+template<class N>
+N *NodeArena<N>::Relocate(N *node) {
+    if (!isRelocating || !node || !freeIndex || freeIndex >= getIndex(node)) {
+        return node;
+    }
+    N *slot = getNode(freeIndex);
+    freeIndex = *reinterpret_cast<unsigned int *>(slot);
+    memcpy(static_cast<void *>(slot), static_cast<const void *>(node), sizeof(N));
+    *reinterpret_cast<unsigned int *>(node) = retiredIndex;
+    retiredIndex = getIndex(node);
+    return slot;
+}
+
+/**
+ * Closes the relocation pass, closing a pass that is not open does nothing
+ */
+template<class N>
+void NodeArena<N>::EndRelocation() {
+    if (!isRelocating) {
+        return;
+    }
+    isRelocating = false;
+    SortFreeSlots();
+}
+
+/**
+ * Releases every chunk at once, the nodes are not destroyed so they must not
+ * own anything, and no pointer or index to them may be used again
+ */
+template<class N>
+void NodeArena<N>::Clear() {
+    for (unsigned int i = 0; i < numberOfChunks; ++i) {
+        std::free(chunks[i]);
+    }
+    numberOfChunks = 0;
+    nextIndex = 1;
+    freeIndex = 0;
+    retiredIndex = 0;
+    numberOfNodes = 0;
+    isRelocating = false;
+}
+
+/**
+ * Every pool is a NodeArena of one type of node, shared by all the trees
+ * given that pool, and a node links to others by their 32 bit index in the
+ * arena of the chunk the link is stored in
+ */
+struct ArenaStorage {
+    template<class N>
+    using Pool = NodeArena<N>;
+
+    /**
+     * A 32 bit index of a node which behaves like a pointer to it
+     */
+    template<class N>
+    class Link {
+    private:
+        unsigned int index;
+
+    public:
+        Link(N *node = nullptr) : index(NodeArena<N>::getIndex(node)) {}
+
+        operator N *() const {
+            return index ? NodeArena<N>::ArenaOf(this)->getNode(index) : nullptr;
+        }
+
+        N *operator->() const {
+            return NodeArena<N>::ArenaOf(this)->getNode(index);
+        }
+    };
+
+    template<class N>
+    struct NodeBase {
+        static void *operator new(size_t, NodeArena<N> *arena) {
+            return arena->Allocate();
+        }
+
+        static void operator delete(void *node, NodeArena<N> *arena) {
+            arena->Free(node);
+        }
+
+        static void operator delete(void *node) {
+            if (node) {
+                NodeArena<N>::ArenaOf(node)->Free(node);
+            }
+        }
+    };
+
+    template<class N>
+    static NodeArena<N> *PoolOf(const N *node) {
+        return NodeArena<N>::ArenaOf(node);
+    }
+
+    template<class N>
+    static N *Relocate(N *node) {
+        return node ? NodeArena<N>::ArenaOf(node)->Relocate(node) : nullptr;
+    }
+
+    static const bool canReleaseAll = true;
+};
+
+/**
+ * True if the objects of type T are allocated through the storage policy S,
+ * the trees move such data along with their nodes
+ */
+template<class S, class T>
+struct IsStoredIn : std::is_base_of<typename S::template NodeBase<T>, T> {
+};
+
+template<class S, class T>
+T *RelocateData(T *data, std::true_type) {
+    return S::template Relocate<T>(data);
+}
+
+template<class S, class T>
+T *RelocateData(T *data, std::false_type) {
+    return data;
+}
+
+/**
+ * Relocates data allocated through the storage policy S and leaves any other
+ * data in place
+ */
+template<class S, class T>
+T *RelocateData(T *data) {
+    return RelocateData<S, T>(data, IsStoredIn<S, T>());
+}
+
+#endif //WET2_NODESTORAGE_H
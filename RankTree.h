@@ -7,44 +7,121 @@
 
 #include <cmath>
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include "BalancePolicy.h"
+#include "KeyCompare.h"
+#include "NodeStorage.h"
 
 using std::max;
 using std::ceil;
 using std::log2;
 using std::pow;
 
+/**
+ * A batch of changes with at least one key per rankTreeRebuildFactor nodes in
+ * the tree rebuilds the tree from it's sorted nodes instead of changing them
+ * one by one
+ */
+const int rankTreeRebuildFactor = 16;
+
+/**
+ * A subtree of a tree in tombstone mode with more than this percent of it's
+ * nodes as tombstones is rebuilt from it's live nodes
+ */
+const int rankTreeMaxTombstonePercent = 50;
+
+template<class K, class T, bool isReverse, class B, class S>
+class RankTreeIterator;
+
+/**
+ * The data pointer of a RankTreeNode, a node of a tree with void data holds
+ * only it's key so the tree is a set with no data to own or delete
+ * @tparam T Pointer to dynamically allocated object of type T
+ */
+template<class T>
+class RankTreeNodeData {
+protected:
+    T *data;
+
+    explicit RankTreeNodeData(T *data) : data(data) {}
+
+    T *getStoredData() const {
+        return data;
+    }
+
+    void setStoredData(T *nData) {
+        data = nData;
+    }
+
+    void deleteStoredData() {
+        delete data;
+        data = nullptr;
+    }
+};
+
+template<>
+class RankTreeNodeData<void> {
+protected:
+    explicit RankTreeNodeData(void *) {}
+
+    void *getStoredData() const {
+        return nullptr;
+    }
+
+    void setStoredData(void *) {}
+
+    void deleteStoredData() {}
+};
+
 /**
  * Generic Template Class for a RankTreeNode
- * Made Specifically for use as a balanced AVL tree node meant to store dynamic
- * user data
+ * Made Specifically for use as a balanced tree node meant to store dynamic
+ * user data, the balancing scheme is a policy from BalancePolicy.h and the
+ * way the nodes are allocated and linked is a policy from NodeStorage.h
+ * A node removed in tombstone mode stays in the tree marked as deleted, the
+ * rank of a node counts only the live nodes of it's subtree and the size
+ * counts the tombstones too
  */
-template<class K, class T>
-class RankTreeNode {
+template<class K, class T, class B = AvlBalance, class S = PointerStorage>
+class RankTreeNode : private RankTreeNodeData<T>, public S::template NodeBase<RankTreeNode<K, T, B, S>> {
 private:
+    typedef typename S::template Link<RankTreeNode<K, T, B, S>> Link;
+    typedef typename S::template Pool<RankTreeNode<K, T, B, S>> Pool;
+
     K key;
-    T *data;
-    int height = 1;
+    int balance;
     int rank = 1;
-    RankTreeNode<K, T> *left = nullptr;
-    RankTreeNode<K, T> *right = nullptr;
-    RankTreeNode<K, T> *parent = nullptr;
+    // The deleted flag shares the word of the size
+    int size : 31;
+    bool isDeleted : 1;
+    Link left = nullptr;
+    Link right = nullptr;
+    Link parent = nullptr;
 
-    RankTreeNode<K, T> *Rebalance();
+    template<class, class, bool, class, class> friend class RankTreeIterator;
 
-    int getBalanceFactor();
+    friend B;
 
-    void SwapNodesParent(RankTreeNode<K, T> *replacement);
+    void updateRotatedRootParent(RankTreeNode<K, T, B, S> *previousRoot, RankTreeNode<K, T, B, S> *newRoot);
 
-    RankTreeNode<K, T> *LeftRightRotate();
+    RankTreeNode<K, T, B, S> *LeftRotate();
 
-    RankTreeNode<K, T> *RightLeftRotate();
+    RankTreeNode<K, T, B, S> *RightRotate();
 
-    void updateRotatedRootParent(RankTreeNode<K, T> *previousRoot, RankTreeNode<K, T> *newRoot);
+    static RankTreeNode<K, T, B, S> *RecountToRoot(RankTreeNode<K, T, B, S> *node);
 
-    RankTreeNode<K, T> *LeftRotate();
+    static void Unlink(RankTreeNode<K, T, B, S> *target, RankTreeNode<K, T, B, S> **child, RankTreeNode<K, T, B, S> **parent,
+                       bool *isLeftChild);
 
-    RankTreeNode<K, T> *RightRotate();
+    static RankTreeNode<K, T, B, S> *DetachMin(RankTreeNode<K, T, B, S> *root, RankTreeNode<K, T, B, S> **minimum);
+
+    static RankTreeNode<K, T, B, S> *LinkBalanced(RankTreeNode<K, T, B, S> **nodes, int numberOfNodes, int depth,
+                                               int partialDepth);
+
+    static RankTreeNode<K, T, B, S> *MergeSorted(RankTreeNode<K, T, B, S> *root, const K *keys, int numberOfKeys,
+                                              Pool *pool);
 
 public:
     RankTreeNode(K key, T *nData = nullptr, RankTreeNode *parent = nullptr, RankTreeNode *left = nullptr, RankTreeNode *right = nullptr);
@@ -55,75 +132,82 @@ public:
 
     void removeDataPointer();
 
-    int getHeight();
+    int getBalance();
 
     int getRank();
 
-    static K FindNodeByRank(RankTreeNode<K, T> *root, int searchRank);
-
-    void PrintTreeInOrderWithRanks();
+    int getSize();
 
-    int getNodeBalanceFactor();
+    bool IsDeleted();
 
-    int getLeftChildRank();
+    void MarkDeleted();
 
-    int getRightChildRank();
+    void Revive(T *nData);
 
-    int getLeftChildHeight();
+    static K FindNodeByRank(RankTreeNode<K, T, B, S> *root, int searchRank);
 
-    int getRightChildHeight();
+    static RankTreeNode<K, T, B, S> *FindNodeAtRank(RankTreeNode<K, T, B, S> *root, int searchRank);
 
-    RankTreeNode<K, T> *findMin();
+    void PrintTreeInOrderWithRanks();
 
-    RankTreeNode<K, T> *Insert(K nodeKey, T *nodeData = nullptr, RankTreeNode<K, T> *result = nullptr);
+    int getLeftChildRank();
 
-    RankTreeNode<K, T> *Remove(K nodeKey);
+    int getRightChildRank();
 
-    RankTreeNode<K, T> *DeleteNode();
+    RankTreeNode<K, T, B, S> *findMin();
 
-    void updateHeightRecurse();
+    RankTreeNode<K, T, B, S> *Insert(const K &nodeKey, T *nodeData = nullptr, RankTreeNode<K, T, B, S> **result = nullptr);
 
-    void updateNodeHeight();
+    RankTreeNode<K, T, B, S> *Remove(const K &nodeKey);
 
     void updateNodeRank();
 
-    RankTreeNode<K, T> *DeleteAndReplaceNodeWithLeftSuccessor();
+    int FillNodesWithArrDataInOrder(T **&array, int size, int index);
+
+    int FillArrayWithNodesInOrder(RankTreeNode<K, T, B, S> **&array, int size, int index);
 
-    RankTreeNode<K, T> *DeleteAndReplaceNodeWithRightSuccessor();
+    RankTreeNode<K, T, B, S> *Find(const K &searchKey);
 
-    int FillNodesWithArrDataInOrder(T **&array, int size, int index);
+    RankTreeNode<K, T, B, S> *getNext();
 
-    int FillArrayWithNodesInOrder(RankTreeNode<K, T> **&array, int size, int index);
+    RankTreeNode<K, T, B, S> *getPrevious();
 
-    void updateRebalancedNodeHeights(RankTreeNode<K, T> *origin, RankTreeNode<K, T> *newRoot);
+    RankTreeNode<K, T, B, S> *getLeft();
 
-    RankTreeNode<K, T> *Find(K searchKey);
+    void setLeft(RankTreeNode<K, T, B, S> *ptr);
 
-    RankTreeNode<K, T> *getNext();
+    RankTreeNode<K, T, B, S> *getRight();
 
-    RankTreeNode<K, T> *getLeft();
+    void setRight(RankTreeNode<K, T, B, S> *ptr);
 
-    void setLeft(RankTreeNode<K, T> *ptr);
+    RankTreeNode<K, T, B, S> *getParent();
 
-    RankTreeNode<K, T> *getRight();
+    void setParent(RankTreeNode<K, T, B, S> *ptr);
 
-    void setRight(RankTreeNode<K, T> *ptr);
+    RankTreeNode<K, T, B, S> *findMaxNoRank();
 
-    RankTreeNode<K, T> *getParent();
+    void DeleteTreeData();
 
-    void setParent(RankTreeNode<K, T> *ptr);
+    static RankTreeNode<K, T, B, S> *LinkBalanced(RankTreeNode<K, T, B, S> **nodes, int numberOfNodes);
 
-    RankTreeNode<K, T> *findMaxNoRank();
+    static void FillKeysInOrder(RankTreeNode<K, T, B, S> *root, K &key);
 
-    RankTreeNode<K, T> *findMax();
+    static void FillKeysAndDataInOrder(RankTreeNode<K, T, B, S> *root, const K *&keys, T **&data);
 
-    void DeleteTreeData();
+    static RankTreeNode<K, T, B, S> *JoinWithPivot(RankTreeNode<K, T, B, S> *left, RankTreeNode<K, T, B, S> *pivot,
+                                             RankTreeNode<K, T, B, S> *right);
+
+    static RankTreeNode<K, T, B, S> *Join(RankTreeNode<K, T, B, S> *left, RankTreeNode<K, T, B, S> *right);
+
+    static void Split(RankTreeNode<K, T, B, S> *root, const K &key, RankTreeNode<K, T, B, S> **smaller,
+                      RankTreeNode<K, T, B, S> **notSmaller);
 
-    static void CreateCompleteBinaryTree(RankTreeNode<K, T> *root, int treeLevel, int currentLevel);
+    static RankTreeNode<K, T, B, S> *InsertSorted(RankTreeNode<K, T, B, S> *root, const K *keys, int numberOfKeys,
+                                               Pool *pool);
 
-    static void RemoveExtraNodes(RankTreeNode<K, T> *root, int &numberOfNodesToRemove);
+    static RankTreeNode<K, T, B, S> *CompactSubtree(RankTreeNode<K, T, B, S> *node, Pool *pool);
 
-    static void FillKeysInOrder(RankTreeNode<K, T> *root, K &key);
+    static RankTreeNode<K, T, B, S> *Relocate(RankTreeNode<K, T, B, S> *node);
 
     ~RankTreeNode();
 
@@ -136,41 +220,8 @@ public:
  * =============================================================================
  */
 
-/**
- * Checks the balance factor of the tree and rebalances it using the AVL tree
- * rotation algorithms, returns the root of the new subtree at the end
- * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the subtree after rebalancing
- */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::Rebalance() {
-    // Getting the balance factor of the current node
-    int balance = getBalanceFactor();
-
-    if (balance < -1) {
-        // The tree is right heavy
-        int rightSubtreeBalance = getRight()->getBalanceFactor();
-        if (rightSubtreeBalance > 0) {
-            return RightLeftRotate();
-        } else {
-            return RightRotate();
-        }
-
-    } else if (balance > 1) {
-        // The tree is left heavy
-        int leftSubtreeBalance = getLeft()->getBalanceFactor();
-        if (leftSubtreeBalance >= 0) {
-            return LeftRotate();
-        } else {
-            return LeftRightRotate();
-        }
-    }
-
-    return this;
-}
-
-template<class K, class T>
-void RankTreeNode<K, T>::RankSanity() {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::RankSanity() {
     int leftRank = 0;
     int rightRank = 0;
 
@@ -182,74 +233,22 @@ void RankTreeNode<K, T>::RankSanity() {
         right->RankSanity();
         rightRank = right->rank;
     }
-    if (rank != 1+leftRank+rightRank) {
+    if (rank != (isDeleted ? 0 : 1) + leftRank + rightRank) {
         std::cout << "ERROR IN TREE RANK" << std::endl;
     }
 }
 
 /**
- * Calculates the balance factor of the current node
- * @tparam T Pointer to dynamically allocated object of type T
- * @return The balance factor of the current node
- */
-template<class K, class T>
-int RankTreeNode<K, T>::getBalanceFactor() {
-    updateNodeHeight();
-    updateNodeRank();
-    int leftHeight = 0;
-    int rightHeight = 0;
-    if (getRight()) {
-        rightHeight = getRight()->height;
-    }
-    if (getLeft()) {
-        leftHeight = getLeft()->height;
-    }
-    return leftHeight - rightHeight;
-}
-
-/**
- * Updates the pointers of the "next in line" node in order to make sure proper linkage
- * of the subtree after deletion
- * @tparam T Pointer to dynamically allocated object of type T
- * @param replacement The successor node
- */
-template<class K, class T>
-void RankTreeNode<K, T>::SwapNodesParent(RankTreeNode<K, T> *replacement) {
-    if (replacement) {
-        replacement->parent = this->parent;
-        replacement->updateNodeHeight();
-    }
-    if (getParent()) {
-        if (getParent()->getLeft() && getParent()->getLeft()->getKey() == getKey()) {
-            this->parent->left = replacement;
-        } else {
-            this->parent->right = replacement;
-        }
-        getParent()->updateNodeHeight();
-    }
-}
-
-/**
- * Updates the height of the node based on it's children
- * @tparam T Pointer to dynamically allocated object of type T
- */
-template<class K, class T>
-void RankTreeNode<K, T>::updateNodeHeight() {
-    int leftHeight = getLeftChildHeight();
-    int rightHeight = getRightChildHeight();
-    height = 1 + max(leftHeight, rightHeight);
-}
-
-/**
- * Updates the rank of hte node based on it's children
+ * Updates the rank and size of hte node based on it's children
  * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-void RankTreeNode<K, T>::updateNodeRank() {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::updateNodeRank() {
     int leftRank = getLeftChildRank();
     int rightRank = getRightChildRank();
-    rank = 1 + leftRank + rightRank;
+    rank = (isDeleted ? 0 : 1) + leftRank + rightRank;
+    size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
 }
 
 /**
@@ -257,8 +256,8 @@ void RankTreeNode<K, T>::updateNodeRank() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The rank of the left child
  */
-template<class K, class T>
-int RankTreeNode<K, T>::getLeftChildRank() {
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::getLeftChildRank() {
     if (left) {
         return left->rank;
     }
@@ -270,8 +269,8 @@ int RankTreeNode<K, T>::getLeftChildRank() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The rank of the right child
  */
-template<class K, class T>
-int RankTreeNode<K, T>::getRightChildRank() {
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::getRightChildRank() {
     if (right) {
         return right->rank;
     }
@@ -279,160 +278,382 @@ int RankTreeNode<K, T>::getRightChildRank() {
 }
 
 /**
- * Returns the height of the left child
+ * Performs a left rotation, the left child takes the place of the node
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The height of the left child
+ * @return The new root of the rotated subtree
  */
-template<class K, class T>
-int RankTreeNode<K, T>::getLeftChildHeight() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::LeftRotate() {
+    RankTreeNode<K, T, B, S> *newRoot = left;
+    left = newRoot->right;
     if (left) {
-        return left->height;
+        left->parent = this;
     }
-    return 0;
+    // Moving newRoot to the place of "this"
+    newRoot->right = this;
+    newRoot->parent = this->parent;
+    if (this->parent) {
+        updateRotatedRootParent(this, newRoot);
+    }
+    this->parent = newRoot;
+    // Only the two rotated nodes changed their subtrees
+    B::Update(this);
+    updateNodeRank();
+    B::Update(newRoot);
+    newRoot->updateNodeRank();
+    return newRoot;
 }
 
 /**
- * Returns the height of the right child
+ * Insert a new node to the subtree tree and returns the new root of the subtree
+ * after rotations and rebalance
+ * Must be called on the root of the tree
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The height of the right child
+ * @param nodeKey The key of the new node
+ * @param nodeData The data object of the new node
+ * @param result A pointer to save a reference to the new node in
+ * @return The new root of the rebalanced tree after insert
  */
-template<class K, class T>
-int RankTreeNode<K, T>::getRightChildHeight() {
-    if (right) {
-        return right->height;
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::Insert(const K &nodeKey, T *nodeData, RankTreeNode<K, T, B, S> **result) {
+    // Search for the right place to insert the node
+    RankTreeNode<K, T, B, S> *current = this;
+    RankTreeNode<K, T, B, S> *inserted = nullptr;
+    while (!inserted) {
+        int order = CompareKeys(current->key, nodeKey);
+        if (order < 0) {
+            // The node will be in the right subtree of this node
+            if (!current->right) {
+                current->right = new (S::PoolOf(current)) RankTreeNode(nodeKey, nodeData, current);
+                inserted = current->right;
+            }
+            current = current->right;
+        } else if (order > 0) {
+            // The node will be in the left subtree of this node
+            if (!current->left) {
+                current->left = new (S::PoolOf(current)) RankTreeNode(nodeKey, nodeData, current);
+                inserted = current->left;
+            }
+            current = current->left;
+        } else {
+            // The input key already exists in the tree, returning the tree
+            // without modifying it or the input data
+            return this;
+        }
     }
-    return 0;
+    if (result) {
+        // Saving the new object to the result pointer for future retrieval
+        *result = inserted;
+    }
+    // Rebalancing tree after insertion
+    return B::AfterInsert(inserted);
 }
 
 /**
- * Performs a left right rotation based on AVL tree rotation algorithms
+ * Joins two trees and a pivot node between them into one tree, the keys of
+ * the left tree are smaller than the pivot and the keys of the right tree are
+ * greater than it
+ * The balancing policy places the pivot, for AVL it hangs on the spine of the
+ * taller tree where the heights of the two sides meet and the join takes
+ * O(difference of heights + 1)
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the rotated subtree
+ * @param left The root of the left tree, may be nullptr
+ * @param pivot A single node, it's old links are ignored
+ * @param right The root of the right tree, may be nullptr
+ * @return The root of the joined tree
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::LeftRightRotate() {
-    if (left) {
-        left->RightRotate();
-    }
-    return this->LeftRotate();
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::JoinWithPivot(RankTreeNode<K, T, B, S> *left, RankTreeNode<K, T, B, S> *pivot,
+                                                            RankTreeNode<K, T, B, S> *right) {
+    return B::JoinWithPivot(left, pivot, right);
 }
 
 /**
- * Performs a right left rotation based on AVL tree rotation algorithms
+ * Unlinks the minimal node of a tree without deleting it
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the rotated subtree
+ * @param root The root of the tree, not nullptr
+ * @param minimum A pointer to save the unlinked node in
+ * @return The root of the tree without the minimal node
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::RightLeftRotate() {
-    if (right) {
-        right->LeftRotate();
-    }
-    return this->RightRotate();
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::DetachMin(RankTreeNode<K, T, B, S> *root, RankTreeNode<K, T, B, S> **minimum) {
+    RankTreeNode<K, T, B, S> *node = root->findMin();
+    B::BeforeRemove(node);
+    RankTreeNode<K, T, B, S> *child;
+    RankTreeNode<K, T, B, S> *parentNode;
+    bool isLeftChild;
+    Unlink(node, &child, &parentNode, &isLeftChild);
+    int removedBalance = node->balance;
+    node->left = nullptr;
+    node->right = nullptr;
+    node->parent = nullptr;
+    *minimum = node;
+    return B::AfterRemove(child, parentNode, isLeftChild, removedBalance);
 }
 
 /**
- * Performs a left rotation based on AVL tree rotation algorithms
+ * Joins two trees into one tree, every key of the left tree must be smaller
+ * than every key of the right tree
+ * The minimal node of the right tree is the pivot, O(log n)
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the rotated subtree
+ * @param left The root of the left tree, may be nullptr
+ * @param right The root of the right tree, may be nullptr
+ * @return The root of the joined tree
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::LeftRotate() {
-    RankTreeNode<K, T> *newRoot = left;
-    left = left->right;
-    if (left) {
-        left->parent = this;
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::Join(RankTreeNode<K, T, B, S> *left, RankTreeNode<K, T, B, S> *right) {
+    if (!left) {
+        return right;
     }
-    // Moving newRoot to the place of "this"
-    newRoot->right = this;
-    newRoot->parent = this->parent;
-    if (this->getParent()) {
-        // Checking if newRoot is a right child or left child of the original parent
-        updateRotatedRootParent(this, newRoot);
+    if (!right) {
+        return left;
     }
-    this->parent = newRoot;
-    // Updating node heights after switches
-    if (newRoot->left) {
-        newRoot->left->updateNodeHeight();
-        newRoot->left->updateNodeRank();
-    }
-    if (newRoot->right) {
-        newRoot->right->updateNodeHeight();
-        newRoot->right->updateNodeRank();
-    }
-    updateRebalancedNodeHeights(this, newRoot);
-//    if (newRoot->getParent()) {
-//        newRoot->parent->updateNodeRank();
-//    }
-    return newRoot;
+    RankTreeNode<K, T, B, S> *pivot;
+    right = DetachMin(right, &pivot);
+    return JoinWithPivot(left, pivot, right);
 }
 
 /**
- * Updates the height of nodes that were the core components of a rebalance
+ * Splits a tree into the nodes with keys smaller than the input key and the
+ * nodes with keys not smaller than it, no node is created or deleted
+ * The search path is cut bottom up, every node on it joins one side with the
+ * subtree it keeps, with AVL the joins cost the differences of heights along
+ * the path which add up to O(log n)
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @param origin The original root of the subtree
- * @param newRoot The new root of the subtree
+ * @param root The root of the tree, may be nullptr
+ * @param key The key to split at
+ * @param smaller A pointer to save the root of the smaller keys in
+ * @param notSmaller A pointer to save the root of the other keys in
+ */
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::Split(RankTreeNode<K, T, B, S> *root, const K &key, RankTreeNode<K, T, B, S> **smaller,
+                                  RankTreeNode<K, T, B, S> **notSmaller) {
+    RankTreeNode<K, T, B, S> *node = root;
+    RankTreeNode<K, T, B, S> *last = nullptr;
+    while (node) {
+        last = node;
+        node = (node->key < key) ? node->right : node->left;
+    }
+    RankTreeNode<K, T, B, S> *smallerRoot = nullptr;
+    RankTreeNode<K, T, B, S> *notSmallerRoot = nullptr;
+    node = last;
+    while (node) {
+        // The child on the search path is already part of one of the sides
+        RankTreeNode<K, T, B, S> *next = node->parent;
+        if (node->key < key) {
+            RankTreeNode<K, T, B, S> *kept = node->left;
+            if (kept) {
+                kept->parent = nullptr;
+            }
+            smallerRoot = JoinWithPivot(kept, node, smallerRoot);
+        } else {
+            RankTreeNode<K, T, B, S> *kept = node->right;
+            if (kept) {
+                kept->parent = nullptr;
+            }
+            notSmallerRoot = JoinWithPivot(notSmallerRoot, node, kept);
+        }
+        node = next;
+    }
+    *smaller = smallerRoot;
+    *notSmaller = notSmallerRoot;
+}
+
+/**
+ * Links sorted nodes into an almost complete tree, the middle node of every
+ * range is the root of it's subtree so the sizes of siblings differ by at
+ * most one and all the nulls are on the last two levels, O(number of nodes)
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param nodes The nodes to link sorted by key, their old links are ignored
+ * @param numberOfNodes The number of nodes
+ * @return The root of the linked tree, it's parent is nullptr
  */
-template<class K, class T>
-void RankTreeNode<K, T>::updateRebalancedNodeHeights(RankTreeNode<K, T> *origin, RankTreeNode<K, T> *newRoot) {
-    if (origin->right) {
-        origin->right->updateNodeHeight();
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::LinkBalanced(RankTreeNode<K, T, B, S> **nodes, int numberOfNodes) {
+    // The deepest level is full only if it holds 2^depth nodes
+    int partialDepth = 0;
+    while ((2LL << partialDepth) - 1 <= numberOfNodes) {
+        partialDepth++;
+    }
+    RankTreeNode<K, T, B, S> *root = LinkBalanced(nodes, numberOfNodes, 0, partialDepth);
+    if (root) {
+        root->parent = nullptr;
     }
-    if (origin->left) {
-        origin->left->updateNodeHeight();
+    return root;
+}
+
+/**
+ * Links a range of sorted nodes into a subtree at the input depth, the state
+ * of the balancing policy is set bottom up
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param nodes The nodes to link sorted by key, their old links are ignored
+ * @param numberOfNodes The number of nodes
+ * @param depth The depth of the root of the subtree in the whole tree
+ * @param partialDepth The depth of the only level that may be partial
+ * @return The root of the linked subtree, it's parent is not set
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::LinkBalanced(RankTreeNode<K, T, B, S> **nodes, int numberOfNodes, int depth,
+                                                           int partialDepth) {
+    if (numberOfNodes == 0) {
+        return nullptr;
     }
-    origin->updateNodeHeight();
-    origin->updateNodeRank();
-    if (newRoot->right) {
-        newRoot->right->updateNodeHeight();
+    int middle = numberOfNodes / 2;
+    RankTreeNode<K, T, B, S> *node = nodes[middle];
+    node->left = LinkBalanced(nodes, middle, depth + 1, partialDepth);
+    node->right = LinkBalanced(nodes + middle + 1, numberOfNodes - middle - 1, depth + 1, partialDepth);
+    if (node->left) {
+        node->left->parent = node;
     }
-    if (newRoot->left) {
-        newRoot->left->updateNodeHeight();
+    if (node->right) {
+        node->right->parent = node;
     }
-    newRoot->updateNodeHeight();
-    newRoot->updateNodeRank();
+    B::InitBuilt(node, depth, partialDepth);
+    node->updateNodeRank();
+    return node;
 }
 
 /**
- * Insert a new node to the subtree tree and returns the new root of the subtree
- * after rotations and rebalance
+ * Merges sorted keys into the nodes of a subtree and relinks it as an almost
+ * complete tree in O(size + keys) without any rotations
+ * The old nodes are reused, tombstones are deleted unless a key revives them
+ * and keys that already exist are ignored
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @param nodeKey The key of the new node
- * @param nodeData The data object of the new node
- * @param result A pointer to save a reference to the new node in
- * @return The new root of the rebalanced tree after insert
+ * @param root The root of the subtree, may be nullptr
+ * @param keys The keys to insert, sorted without duplicates
+ * @param numberOfKeys The number of keys
+ * @param pool The pool to allocate the new nodes from
+ * @return The root of the merged subtree, it's parent is nullptr
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::Insert(K nodeKey, T *nodeData, RankTreeNode<K, T> *result) {
-    // Search for the right place to insert the node
-    if (nodeKey > getKey()) {
-        // The node will be a right child of this node
-        if (!right) {
-            // Found the correct spot to insert the node
-            right = new RankTreeNode(nodeKey, nodeData, this);
-            // Saving the new object to the result pointer for future retrieval
-            result = right;
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::MergeSorted(RankTreeNode<K, T, B, S> *root, const K *keys,
+                                                          int numberOfKeys, Pool *pool) {
+    int numberOfNodes = root ? root->size : 0;
+    RankTreeNode<K, T, B, S> **oldNodes = new RankTreeNode<K, T, B, S> *[numberOfNodes + 1];
+    RankTreeNode<K, T, B, S> **nodes = new RankTreeNode<K, T, B, S> *[numberOfNodes + numberOfKeys];
+    if (root) {
+        RankTreeNode<K, T, B, S> **oldNodesArray = oldNodes;
+        root->FillArrayWithNodesInOrder(oldNodesArray, numberOfNodes, 0);
+    }
+
+    int size = 0;
+    int oldIndex = 0;
+    int keyIndex = 0;
+    while (oldIndex < numberOfNodes || keyIndex < numberOfKeys) {
+        int order = (keyIndex == numberOfKeys) ? -1 :
+                    (oldIndex == numberOfNodes) ? 1 : CompareKeys(oldNodes[oldIndex]->key, keys[keyIndex]);
+        if (order < 0) {
+            RankTreeNode<K, T, B, S> *node = oldNodes[oldIndex++];
+            if (node->isDeleted) {
+                delete node;
+            } else {
+                nodes[size++] = node;
+            }
+        } else if (order == 0) {
+            // The key already has a node, a tombstone comes back to life
+            RankTreeNode<K, T, B, S> *node = oldNodes[oldIndex++];
+            node->isDeleted = false;
+            nodes[size++] = node;
+            keyIndex++;
         } else {
-            // Need to continue searching for the right spot of the new node
-            right->Insert(nodeKey, nodeData, result);
+            nodes[size++] = new (pool) RankTreeNode<K, T, B, S>(keys[keyIndex++]);
         }
-    } else if (nodeKey < getKey()) {
-        // The node will be a left child of this node
-        if (!left) {
-            // Found the correct spot to insert the node
-            left = new RankTreeNode(nodeKey, nodeData, this);
-            // Saving the new object to the result pointer for future retrieval
-            result = left;
-        } else {
-            // Need to continue searching for the right spot of the new node
-            left->Insert(nodeKey, nodeData, result);
+    }
+    delete[] oldNodes;
+    RankTreeNode<K, T, B, S> *merged = LinkBalanced(nodes, size);
+    delete[] nodes;
+    return merged;
+}
+
+/**
+ * Inserts sorted keys into a tree in one descent, the keys are split around
+ * every node on the way and each side goes down only to the subtree that
+ * holds it's keys
+ * A subtree that gets at least one key per rankTreeRebuildFactor nodes on both
+ * sides of it's root is rebuilt from the merged sorted sequence instead of
+ * being rotated key by key, the descent then joins the results back around the
+ * nodes it passed so the tree stays balanced, O(k log(n / k + 1)) for k keys
+ * scattered in a tree of n nodes and O(n + k) in the worst case
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param root The root of the tree, may be nullptr
+ * @param keys The keys to insert, sorted without duplicates
+ * @param numberOfKeys The number of keys
+ * @param pool The pool to allocate the new nodes from
+ * @return The root of the tree with the new keys, it's parent is nullptr
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::InsertSorted(RankTreeNode<K, T, B, S> *root, const K *keys,
+                                                           int numberOfKeys, Pool *pool) {
+    if (numberOfKeys == 0) {
+        return root;
+    }
+    if (!root) {
+        return MergeSorted(root, keys, numberOfKeys, pool);
+    }
+    int numberOfSmaller = (int) (std::lower_bound(keys, keys + numberOfKeys, root->key) - keys);
+    bool isRootInBatch = numberOfSmaller < numberOfKeys && !(root->key < keys[numberOfSmaller]);
+    int firstGreater = isRootInBatch ? numberOfSmaller + 1 : numberOfSmaller;
+    // Keys that all go to one side of the root keep the other side untouched
+    // instead of rebuilding it too
+    bool isOneSided = numberOfSmaller == 0 || firstGreater == numberOfKeys;
+    if (!isOneSided && (long long) numberOfKeys * rankTreeRebuildFactor >= root->size) {
+        return MergeSorted(root, keys, numberOfKeys, pool);
+    }
+    if (isRootInBatch) {
+        // A tombstone comes back to life
+        root->isDeleted = false;
+    }
+    RankTreeNode<K, T, B, S> *left = root->left;
+    RankTreeNode<K, T, B, S> *right = root->right;
+    if (left) {
+        left->parent = nullptr;
+    }
+    if (right) {
+        right->parent = nullptr;
+    }
+    left = InsertSorted(left, keys, numberOfSmaller, pool);
+    right = InsertSorted(right, keys + firstGreater, numberOfKeys - firstGreater, pool);
+    return JoinWithPivot(left, root, right);
+}
+
+/**
+ * Rebuilds the subtree of a node from it's live nodes, deleting it's
+ * tombstones, and joins the result back around the ancestors of the node
+ * A rebuilt subtree may be much shorter than the one it replaces, so each
+ * ancestor is joined with it's other child like the pieces of a split, which
+ * keeps the tree balanced in O(log n) above the O(size) rebuild
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param node The root of the subtree to rebuild
+ * @param pool The pool the nodes were allocated from
+ * @return The root of the tree, it's parent is nullptr
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::CompactSubtree(RankTreeNode<K, T, B, S> *node, Pool *pool) {
+    RankTreeNode<K, T, B, S> *ancestor = node->parent;
+    bool isLeftChild = ancestor && ancestor->left == node;
+    node->parent = nullptr;
+    RankTreeNode<K, T, B, S> *rebuilt = MergeSorted(node, nullptr, 0, pool);
+    while (ancestor) {
+        RankTreeNode<K, T, B, S> *next = ancestor->parent;
+        bool isNextLeftChild = next && next->left == ancestor;
+        RankTreeNode<K, T, B, S> *kept = isLeftChild ? ancestor->right : ancestor->left;
+        if (kept) {
+            kept->parent = nullptr;
         }
-    } else {
-        // The input key already exists in the tree, returning nullptr without
-        // modifying the tree or the input data
-        return nullptr;
+        rebuilt = isLeftChild ? JoinWithPivot(rebuilt, ancestor, kept) : JoinWithPivot(kept, ancestor, rebuilt);
+        ancestor = next;
+        isLeftChild = isNextLeftChild;
     }
-    // Rebalancing tree after insertion
-    return Rebalance();
+    return rebuilt;
 }
 
 /**
@@ -441,10 +662,11 @@ RankTreeNode<K, T> *RankTreeNode<K, T>::Insert(K nodeKey, T *nodeData, RankTreeN
  * @param previousRoot The old root of the subtree
  * @param newRoot The new root of the subtree
  */
-template<class K, class T>
-void RankTreeNode<K, T>::updateRotatedRootParent(RankTreeNode<K, T> *previousRoot, RankTreeNode<K, T> *newRoot) {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::updateRotatedRootParent(RankTreeNode<K, T, B, S> *previousRoot,
+                                                    RankTreeNode<K, T, B, S> *newRoot) {
     // Checking if newRoot is a right child or left child of the original parent
-    if (previousRoot->getParent()->getLeft() && previousRoot->getParent()->getLeft()->getKey() == previousRoot->getKey()) {
+    if (previousRoot->parent->left == previousRoot) {
         previousRoot->parent->left = newRoot;
     } else {
         previousRoot->parent->right = newRoot;
@@ -452,97 +674,36 @@ void RankTreeNode<K, T>::updateRotatedRootParent(RankTreeNode<K, T> *previousRoo
 }
 
 /**
- * Performs a right rotation based on AVL tree rotation algorithms
+ * Performs a right rotation, the right child takes the place of the node
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The new root of the rotated subtree
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::RightRotate() {
-    RankTreeNode<K, T> *newRoot = right;
-    right = right->left;
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::RightRotate() {
+    RankTreeNode<K, T, B, S> *newRoot = right;
+    right = newRoot->left;
     if (right) {
         right->parent = this;
     }
     // Moving newRoot to the place of "this"
     newRoot->left = this;
     newRoot->parent = this->parent;
-    if (this->getParent()) {
-        // Checking if newRoot is a right child or left child of the original parent
+    if (this->parent) {
         updateRotatedRootParent(this, newRoot);
     }
-
     this->parent = newRoot;
-    // Updating node heights after switches
-    if (newRoot->left) {
-        newRoot->left->updateNodeHeight();
-        newRoot->left->updateNodeRank();
-    }
-    if (newRoot->right) {
-        newRoot->right->updateNodeHeight();
-        newRoot->right->updateNodeRank();
-    }
-    updateRebalancedNodeHeights(this, newRoot);
-//    if (newRoot->getParent()) {
-//        newRoot->parent->updateNodeRank();
-//    }
+    // Only the two rotated nodes changed their subtrees
+    B::Update(this);
+    updateNodeRank();
+    B::Update(newRoot);
+    newRoot->updateNodeRank();
     return newRoot;
 }
 
-/**
- * Replaces a node that is targeted for delete with it's leftmost successor
- * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the node's subtree after it's removal
- */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::DeleteAndReplaceNodeWithLeftSuccessor() {
-    RankTreeNode<K, T> *next = left->findMax();
-    if (left->getRight()) {
-        next->parent->right = next->left;
-        if (next->getLeft()) {
-            next->left->parent = next->parent;
-            if (next->left->parent) {
-                next->left->parent->updateNodeHeight();
-                next->left->parent->updateNodeRank();
-            }
-        }
-        // might need to be reversed
-        this->left->parent = next;
-        next->left = this->left;
-    }
-    // Performing pointer and parent swap between the next node and the
-    // node we need to delete
-    this->SwapNodesParent(next);
-    next->right = this->right;
-    if (this->getRight()) {
-        this->right->parent = next;
-    }
-    delete this;
-    next->updateNodeHeight();
-    return next->Rebalance();
-}
-
-/**
- * Replaces a node that is targeted for delete with it's right successor
- * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the node's subtree after it's removal
- */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::DeleteAndReplaceNodeWithRightSuccessor() {
-    RankTreeNode<K, T> *next = this->right;
-    // Performing pointer and parent swap between the next node and the
-    // node we need to delete
-    this->SwapNodesParent(next);
-    delete this;
-//    if (next->getParent()) {
-//        next->getParent()->rank = next->getParent()->rank - 1;
-//    }
-    return next->Rebalance();
-}
-
-template<class K, class T>
-RankTreeNode<K, T>::RankTreeNode(K key, T *nData, RankTreeNode *parent, RankTreeNode *left, RankTreeNode *right):
-        key(key), data(nData) {
-    height = 1;
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S>::RankTreeNode(K key, T *nData, RankTreeNode *parent, RankTreeNode *left, RankTreeNode *right):
+        RankTreeNodeData<T>(nData), key(key), size(1), isDeleted(false) {
+    B::Init(this);
     rank = 1;
     this->left = left;
     this->right = right;
@@ -554,8 +715,8 @@ RankTreeNode<K, T>::RankTreeNode(K key, T *nData, RankTreeNode *parent, RankTree
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The key of the tree node
  */
-template<class K, class T>
-K RankTreeNode<K, T>::getKey() {
+template<class K, class T, class B, class S>
+K RankTreeNode<K, T, B, S>::getKey() {
     return key;
 }
 
@@ -564,22 +725,20 @@ K RankTreeNode<K, T>::getKey() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The data stored in the tree node
  */
-template<class K, class T>
-T *RankTreeNode<K, T>::getData() {
-    if (data) {
-        return data;
-    }
-    return nullptr;
+template<class K, class T, class B, class S>
+T *RankTreeNode<K, T, B, S>::getData() {
+    return this->getStoredData();
 }
 
 /**
- * Returns the height of the node
+ * Returns the state the balancing policy keeps in the node, the height for
+ * AVL, the color for red-black and the priority for a treap
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The height of the tree node
+ * @return The balance state of the tree node
  */
-template<class K, class T>
-int RankTreeNode<K, T>::getHeight() {
-    return height;
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::getBalance() {
+    return balance;
 }
 
 /**
@@ -588,8 +747,8 @@ int RankTreeNode<K, T>::getHeight() {
  * also marks every deleted node as nullptr
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-void RankTreeNode<K, T>::DeleteTreeData() {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::DeleteTreeData() {
     if (left) {
         left->DeleteTreeData();
         delete left;
@@ -602,39 +761,54 @@ void RankTreeNode<K, T>::DeleteTreeData() {
     }
 }
 
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::getNext() {
-    RankTreeNode<K, T> *current = this;
-    if (current->getRight() != nullptr) {
+/**
+ * Finds the node with the next key in the tree
+ * Climbing to the parent compares node pointers only, so every step of an in
+ * order scan is O(1) amortized
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @return The next node, nullptr if this node has the maximal key
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::getNext() {
+    RankTreeNode<K, T, B, S> *current = this;
+    if (current->right) {
         // This node has a right child, which means if we follow the branch
         // once to the right and then all the way to the left, we will find the
         // correct following child
-        RankTreeNode<K, T> *rightOfCurrent = current->getRight();
-        return rightOfCurrent->findMin();
-    } else {
-        RankTreeNode<K, T> *parent = current->getParent();
-        while (parent != nullptr) {
-            RankTreeNode<K, T> *child = parent->getLeft();
-            if (child && child->getKey() == current->getKey()) {
-                // The node we started with is the left child of the current parent,
-                // which means the parent is the next node in the tree.
-                return parent;
-            }
-            current = parent;
-            parent = current->getParent();
+        current = current->right;
+        while (current->left) {
+            current = current->left;
         }
-        return parent;
+        return current;
     }
+    // The next node is the first ancestor whose left subtree holds this node
+    while (current->parent && current->parent->right == current) {
+        current = current->parent;
+    }
+    return current->parent;
 }
 
 /**
- * Returns the balance factor of the node
+ * Finds the node with the previous key in the tree, symmetric to getNext
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The balance factor of the tree node
+ * @return The previous node, nullptr if this node has the minimal key
  */
-template<class K, class T>
-int RankTreeNode<K, T>::getNodeBalanceFactor() {
-    return getBalanceFactor();
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::getPrevious() {
+    RankTreeNode<K, T, B, S> *current = this;
+    if (current->left) {
+        current = current->left;
+        while (current->right) {
+            current = current->right;
+        }
+        return current;
+    }
+    while (current->parent && current->parent->left == current) {
+        current = current->parent;
+    }
+    return current->parent;
 }
 
 /**
@@ -643,12 +817,9 @@ int RankTreeNode<K, T>::getNodeBalanceFactor() {
  * (does not delete child nodes)
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-RankTreeNode<K, T>::~RankTreeNode() {
-    if (data) {
-        delete data;
-        data = nullptr;
-    }
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S>::~RankTreeNode() {
+    this->deleteStoredData();
 }
 
 /**
@@ -657,80 +828,122 @@ RankTreeNode<K, T>::~RankTreeNode() {
  * @param searchKey The key of the node to search for
  * @return A pointer to the tree node if it is found, nullptr otherwise
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::Find(K searchKey) {
-    if (getKey() > searchKey) {
-        // The node we are looking for is a left child of this node
-        if (left) {
-            return left->Find(searchKey);
-        } else {
-            return nullptr;
-        }
-    } else if (getKey() < searchKey) {
-        // The node we are looking for is a right child of this node
-        if (right) {
-            return right->Find(searchKey);
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::Find(const K &searchKey) {
+    RankTreeNode<K, T, B, S> *current = this;
+    while (current) {
+        int order = CompareKeys(searchKey, current->key);
+        if (order < 0) {
+            // The node we are looking for is in the left subtree
+            current = current->left;
+        } else if (order > 0) {
+            // The node we are looking for is in the right subtree
+            current = current->right;
         } else {
-            return nullptr;
+            // We found the node we were looking for
+            return current;
         }
-    } else {
-        // We found the node we were looking for
-        return this;
     }
+    return nullptr;
 }
 
 /**
  * Removes a node with input key from the tree
+ * Must be called on the root of the tree
  * @tparam T Pointer to dynamically allocated object of type T
  * @param nodeKey The key of the node to remove
- * @return The new root of the subtree after removal of the node
- */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::Remove(K nodeKey) {
-    // Searching for the node to remove
-    if (nodeKey > getKey()) {
-        // The delete target is a right child of the current node
-        if (right) {
-            right->Remove(nodeKey);
+ * @return The new root of the tree after removal of the node
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::Remove(const K &nodeKey) {
+    RankTreeNode<K, T, B, S> *target = Find(nodeKey);
+    if (!target) {
+        return this;
+    }
+    B::BeforeRemove(target);
+    RankTreeNode<K, T, B, S> *child;
+    RankTreeNode<K, T, B, S> *parentNode;
+    bool isLeftChild;
+    Unlink(target, &child, &parentNode, &isLeftChild);
+    int removedBalance = target->balance;
+    delete target;
+    return B::AfterRemove(child, parentNode, isLeftChild, removedBalance);
+}
+
+/**
+ * Unlinks a node from the tree without deleting it or fixing the balance, a
+ * node with two children is replaced by the maximal node of it's left subtree
+ * which also takes it's balance state, so the state left in the unlinked node
+ * is that of the place that was actually removed
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param target The node to unlink
+ * @param child A pointer to save the node that moved up to the removed place in
+ * @param parent A pointer to save the parent of the removed place in, it is
+ * the lowest node whose subtree lost a node
+ * @param isLeftChild A pointer to save whether the removed place is a left child
+ */
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::Unlink(RankTreeNode<K, T, B, S> *target, RankTreeNode<K, T, B, S> **child,
+                                   RankTreeNode<K, T, B, S> **parent, bool *isLeftChild) {
+    // The node that takes the place of the removed node
+    RankTreeNode<K, T, B, S> *replacement;
+    if (target->left && target->right) {
+        // Replacing the node with the maximal node of it's left subtree
+        replacement = target->left->findMaxNoRank();
+        *child = replacement->left;
+        if (replacement == target->left) {
+            *parent = replacement;
+            *isLeftChild = true;
         } else {
-            return this;
+            *parent = replacement->parent;
+            *isLeftChild = false;
+            (*parent)->right = replacement->left;
+            if (replacement->left) {
+                replacement->left->parent = *parent;
+            }
+            replacement->left = target->left;
+            target->left->parent = replacement;
         }
-    } else if (nodeKey < getKey()) {
-        // The delete target is a left child of the current node
-        if (left) {
-            left->Remove(nodeKey);
+        replacement->right = target->right;
+        target->right->parent = replacement;
+        std::swap(replacement->balance, target->balance);
+    } else {
+        // The node has at most one child, which moves up in it's place
+        replacement = target->left ? target->left : target->right;
+        *child = replacement;
+        *parent = target->parent;
+        *isLeftChild = target->parent && target->parent->left == target;
+    }
+    // Linking the replacement to the parent of the removed node
+    if (replacement) {
+        replacement->parent = target->parent;
+    }
+    if (target->parent) {
+        if (target->parent->left == target) {
+            target->parent->left = replacement;
         } else {
-            return this;
+            target->parent->right = replacement;
         }
-    } else {
-        // Found the node we need to delete
-        // Using delete handler to remove the node from the tree
-        return this->DeleteNode();
     }
-    // Rebalancing tree after removal
-    return Rebalance();
 }
 
 /**
- * Deletes the node from the tree, returns the new root of the node's subtree
- * after it's removal
+ * Recounts the ranks and sizes from the input node up to the root
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The new root of the node's subtree after it's removal
+ * @param node The lowest node whose subtree changed, may be nullptr
+ * @return The root of the tree, nullptr if the input node is nullptr
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::DeleteNode() {
-    // Search for the next node to act as subtree root
-    if (left) {
-        return DeleteAndReplaceNodeWithLeftSuccessor();
-    } else if (right) {
-        return DeleteAndReplaceNodeWithRightSuccessor();
-    } else {
-        // The node we want to delete has no leafs, so it's subtree will remain empty
-        // after deletion.
-        this->SwapNodesParent(nullptr);
-        delete this;
-        return nullptr;
-    }
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::RecountToRoot(RankTreeNode<K, T, B, S> *node) {
+    RankTreeNode<K, T, B, S> *top = nullptr;
+    while (node) {
+        node->updateNodeRank();
+        top = node;
+        node = node->parent;
+    }
+    return top;
 }
 
 /**
@@ -738,8 +951,8 @@ RankTreeNode<K, T> *RankTreeNode<K, T>::DeleteNode() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The minimal node
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::findMin() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::findMin() {
     if (left) {
         return left->findMin();
     }
@@ -751,34 +964,50 @@ RankTreeNode<K, T> *RankTreeNode<K, T>::findMin() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The maximal node
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::findMaxNoRank() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::findMaxNoRank() {
     if (right) {
         return right->findMaxNoRank();
     }
     return this;
 }
 
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::findMax() {
-    if (right) {
-        RankTreeNode<K, T> *temp = right->findMax();
-        this->updateNodeRank();
-        this->updateNodeHeight();
-        return temp;
-    }
-    this->rank = this->rank - 1;
-    this->height = 0;
-    return this;
-}
-
 /**
- * Returns the left child of the node
+ * Moves a node and it's data to lower free slots of their arenas during a
+ * relocation pass (see NodeStorage.h), and fixes the links of it's parent and
+ * children
  * @tparam T Pointer to dynamically allocated object of type T
- * @return The left child of the node
+ * @param node The node to move
+ * @return The new address of the node
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::getLeft() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::Relocate(RankTreeNode<K, T, B, S> *node) {
+    RankTreeNode<K, T, B, S> *moved = S::template Relocate<RankTreeNode<K, T, B, S>>(node);
+    if (moved != node) {
+        RankTreeNode<K, T, B, S> *parentNode = moved->parent;
+        if (parentNode && parentNode->left == node) {
+            parentNode->left = moved;
+        } else if (parentNode) {
+            parentNode->right = moved;
+        }
+        if (moved->left) {
+            moved->left->parent = moved;
+        }
+        if (moved->right) {
+            moved->right->parent = moved;
+        }
+    }
+    moved->setStoredData(RelocateData<S>(moved->getStoredData()));
+    return moved;
+}
+
+/**
+ * Returns the left child of the node
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @return The left child of the node
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::getLeft() {
     return left;
 }
 
@@ -787,8 +1016,8 @@ RankTreeNode<K, T> *RankTreeNode<K, T>::getLeft() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @param ptr The new left child of the node
  */
-template<class K, class T>
-void RankTreeNode<K, T>::setLeft(RankTreeNode<K, T> *ptr) {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::setLeft(RankTreeNode<K, T, B, S> *ptr) {
     left = ptr;
 }
 
@@ -797,8 +1026,8 @@ void RankTreeNode<K, T>::setLeft(RankTreeNode<K, T> *ptr) {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The right child of the node
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::getRight() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::getRight() {
     return right;
 }
 
@@ -807,8 +1036,8 @@ RankTreeNode<K, T> *RankTreeNode<K, T>::getRight() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @param ptr The new right child of the node
  */
-template<class K, class T>
-void RankTreeNode<K, T>::setRight(RankTreeNode<K, T> *ptr) {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::setRight(RankTreeNode<K, T, B, S> *ptr) {
     right = ptr;
 }
 
@@ -817,8 +1046,8 @@ void RankTreeNode<K, T>::setRight(RankTreeNode<K, T> *ptr) {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return The parent of the node
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTreeNode<K, T>::getParent() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::getParent() {
     return parent;
 }
 
@@ -827,8 +1056,8 @@ RankTreeNode<K, T> *RankTreeNode<K, T>::getParent() {
  * @tparam T Pointer to dynamically allocated object of type T
  * @param ptr The new parent of the node
  */
-template<class K, class T>
-void RankTreeNode<K, T>::setParent(RankTreeNode<K, T> *ptr) {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::setParent(RankTreeNode<K, T, B, S> *ptr) {
     parent = ptr;
 }
 
@@ -836,20 +1065,20 @@ void RankTreeNode<K, T>::setParent(RankTreeNode<K, T> *ptr) {
  * Removes the reference to the data of the node
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-void RankTreeNode<K, T>::removeDataPointer() {
-    data = nullptr;
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::removeDataPointer() {
+    this->setStoredData(nullptr);
 }
 
-template<class K, class T>
-int RankTreeNode<K, T>::FillNodesWithArrDataInOrder(T **&array, int size, int index) {
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::FillNodesWithArrDataInOrder(T **&array, int size, int index) {
     // Insert on left
     if (this->left) {
         index = this->left->FillNodesWithArrDataInOrder(array, size, index);
     }
 
     // Insert on root
-    data = array[key];
+    this->setStoredData(array[key]);
     index++;
 
     // Insert on right
@@ -868,8 +1097,8 @@ int RankTreeNode<K, T>::FillNodesWithArrDataInOrder(T **&array, int size, int in
  * @param index The current insertion position
  * @return The next index to insert values to the array
  */
-template<class K, class T>
-int RankTreeNode<K, T>::FillArrayWithNodesInOrder(RankTreeNode<K, T> **&array, int size, int index) {
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::FillArrayWithNodesInOrder(RankTreeNode<K, T, B, S> **&array, int size, int index) {
     // Scan left
     if (this->left) {
         index = this->left->FillArrayWithNodesInOrder(array, size, index);
@@ -886,111 +1115,151 @@ int RankTreeNode<K, T>::FillArrayWithNodesInOrder(RankTreeNode<K, T> **&array, i
 }
 
 /**
- * Creates a complete binary tree according to the current tree level
- * relative to the full height of the tree
+ * Fills the nodes of the tree with keys using in order scan
  * @tparam T Pointer to dynamically allocated object of type T
- * @param root The root to create children for
- * @param treeLevel The total level the tree should reach
- * @param currentLevel The current level of the tree
+ * @param root The root of the current subtree
+ * @param key The current node's key
  */
-template<class K, class T>
-void RankTreeNode<K, T>::CreateCompleteBinaryTree(RankTreeNode<K, T> *root, int treeLevel, int currentLevel) {
-    // Checking if we created all necessary tree levels
-    if (treeLevel <= currentLevel) {
-        // We finished creating all new levels of the tree
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::FillKeysInOrder(RankTreeNode<K, T, B, S> *root, K &key) {
+    // We reached an empty node, no need to assign key
+    if (!root) {
         return;
     }
-    root->left = new RankTreeNode<K, T>(0, nullptr, root);
-    root->right = new RankTreeNode<K, T>(0, nullptr, root);
-    CreateCompleteBinaryTree(root->left, treeLevel, currentLevel + 1);
-    CreateCompleteBinaryTree(root->right, treeLevel, currentLevel + 1);
-    // Updating root height
-    root->updateNodeHeight();
-    root->updateNodeRank();
+    // Filling keys in the left part of the tree
+    FillKeysInOrder(root->left, key);
+    // Setting current node's key
+    root->key = key++;
+    // Filling keys in the right part of the tree
+    FillKeysInOrder(root->right, key);
 }
 
 /**
- * Removes unnecessary nodes from a Complete Binary Tree
+ * Fills the nodes of the tree with keys and data taken in order from sorted
+ * arrays using in order scan
  * @tparam T Pointer to dynamically allocated object of type T
  * @param root The root of the current subtree
- * @param numberOfNodesToRemove The number of nodes left to remove
- */
-template<class K, class T>
-void RankTreeNode<K, T>::RemoveExtraNodes(RankTreeNode<K, T> *root, int &numberOfNodesToRemove) {
-    // Checking if we need to continue removing nodes
-    if (numberOfNodesToRemove == 0 || !root) {
-        // We removed all the nodes we needed or we reached the end of the tree
-        // scan so we shouldn't perform anymore actions
-        return;
-    }
-    // Removing nodes in reverse in order, only from the bottom level of the tree
-    RemoveExtraNodes(root->right, numberOfNodesToRemove);
-    if (root->left == nullptr && root->right == nullptr) {
-        if (root->parent) {
-            // Setting the child of parent as nullptr to avoid segfault
-            if (root->parent->left == root) {
-                root->parent->left = nullptr;
-            } else {
-                root->parent->right = nullptr;
-            }
-        }
-        numberOfNodesToRemove--;
-        delete root;
+ * @param keys The next key to assign, moved past the assigned keys
+ * @param data The next data to assign, moved past the assigned data
+ */
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::FillKeysAndDataInOrder(RankTreeNode<K, T, B, S> *root, const K *&keys, T **&data) {
+    if (!root) {
         return;
     }
-    RemoveExtraNodes(root->left, numberOfNodesToRemove);
-    root->updateNodeHeight();
-    root->updateNodeRank();
+    FillKeysAndDataInOrder(root->left, keys, data);
+    root->key = *keys++;
+    root->setStoredData(*data++);
+    FillKeysAndDataInOrder(root->right, keys, data);
+}
+
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::getRank() {
+    return rank;
 }
 
 /**
- * Fills the nodes of the tree with keys using in order scan
+ * Returns the number of nodes in the subtree of the node, tombstones included
  * @tparam T Pointer to dynamically allocated object of type T
- * @param root The root of the current subtree
- * @param key The current node's key
  */
-template<class K, class T>
-void RankTreeNode<K, T>::FillKeysInOrder(RankTreeNode<K, T> *root, K &key) {
-    // We reached an empty node, no need to assign key
-    if (!root) {
-        return;
+template<class K, class T, class B, class S>
+int RankTreeNode<K, T, B, S>::getSize() {
+    return size;
+}
+
+template<class K, class T, class B, class S>
+bool RankTreeNode<K, T, B, S>::IsDeleted() {
+    return isDeleted;
+}
+
+/**
+ * Turns a live node into a tombstone, deleting it's data
+ * The node stays in place so nothing is rotated, only the ranks of the node
+ * and it's ancestors drop by one
+ * @tparam T Pointer to dynamically allocated object of type T
+ */
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::MarkDeleted() {
+    this->deleteStoredData();
+    isDeleted = true;
+    for (RankTreeNode<K, T, B, S> *current = this; current; current = current->parent) {
+        current->rank--;
     }
-    // Filling keys in the left part of the tree
-    FillKeysInOrder(root->left, key);
-    // Setting current node's key
-    root->key = key++;
-    // Filling keys in the right part of the tree
-    FillKeysInOrder(root->right, key);
 }
 
-template<class K, class T>
-int RankTreeNode<K, T>::getRank() {
-    return rank;
+/**
+ * Turns a tombstone back into a live node holding new data
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param nData The new data of the node
+ */
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::Revive(T *nData) {
+    this->setStoredData(nData);
+    isDeleted = false;
+    for (RankTreeNode<K, T, B, S> *current = this; current; current = current->parent) {
+        current->rank++;
+    }
 }
 
-template<class K, class T>
-K RankTreeNode<K, T>::FindNodeByRank(RankTreeNode<K, T> *root, int searchRank) {
-    if (root->right) {
-        if (root->right->rank == searchRank - 1) {
-            return root->key;
-        } else if (root->right->rank > searchRank - 1) {
-            return FindNodeByRank(root->right, searchRank);
+/**
+ * Finds the key of the node with the input rank, where the maximal node has
+ * rank 1, tombstones have no rank and are skipped
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param root The root of the tree to search in
+ * @param searchRank The rank of the node to find, between 1 and the size of
+ * the tree
+ * @return The key of the node with the input rank
+ */
+template<class K, class T, class B, class S>
+K RankTreeNode<K, T, B, S>::FindNodeByRank(RankTreeNode<K, T, B, S> *root, int searchRank) {
+    RankTreeNode<K, T, B, S> *current = root;
+    while (true) {
+        int rightRank = current->getRightChildRank();
+        int ownRank = current->isDeleted ? 0 : 1;
+        if (searchRank <= rightRank) {
+            current = current->right;
+        } else if ((ownRank && searchRank == rightRank + 1) || !current->left) {
+            return current->key;
         } else {
-            return FindNodeByRank(root->left, searchRank - root->right->rank - 1);
+            searchRank -= rightRank + ownRank;
+            current = current->left;
         }
-    } else if (root->left) {
-        if (searchRank == 1) {
-            return root->key;
+    }
+}
+
+/**
+ * Finds the node with the input rank, where the maximal node has rank 1,
+ * tombstones have no rank and are skipped
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param root The root of the tree to search in
+ * @param searchRank The rank of the node to find
+ * @return The node with the input rank, nullptr if the rank is not between 1
+ * and the size of the tree
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTreeNode<K, T, B, S>::FindNodeAtRank(RankTreeNode<K, T, B, S> *root, int searchRank) {
+    if (!root || searchRank < 1 || searchRank > root->rank) {
+        return nullptr;
+    }
+    RankTreeNode<K, T, B, S> *current = root;
+    while (true) {
+        int rightRank = current->getRightChildRank();
+        int ownRank = current->isDeleted ? 0 : 1;
+        if (searchRank <= rightRank) {
+            current = current->right;
+        } else if (ownRank && searchRank == rightRank + 1) {
+            return current;
         } else {
-            return root->left->key;
+            searchRank -= rightRank + ownRank;
+            current = current->left;
         }
-    } else {
-        return root->key;
     }
 }
 
-template<class K, class T>
-void RankTreeNode<K, T>::PrintTreeInOrderWithRanks() {
+template<class K, class T, class B, class S>
+void RankTreeNode<K, T, B, S>::PrintTreeInOrderWithRanks() {
     if (left) {
         left->PrintTreeInOrderWithRanks();
     }
@@ -1001,35 +1270,156 @@ void RankTreeNode<K, T>::PrintTreeInOrderWithRanks() {
     }
 }
 
-template<class K, class T>
-void RankTreeNode<K, T>::updateHeightRecurse() {
-    if (left) {
-        left->updateHeightRecurse();
-    }
-    if (right) {
-        right->updateHeightRecurse();
+
+/**
+ * Generic Template Class for an in order iterator over a RankTree
+ * Holds only the current node and steps through the parent pointers, so an
+ * iterator is never allocated and a full scan takes O(n)
+ * Tombstones are skipped, a tree is compacted before it holds more
+ * tombstones than live nodes so the scan stays O(n)
+ * The end of the scan is a nullptr node
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @tparam isReverse True to scan from the maximal key down, which is the
+ * order of increasing rank
+ */
+template<class K, class T, bool isReverse, class B, class S>
+class RankTreeIterator {
+private:
+    RankTreeNode<K, T, B, S> *node;
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef K value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const K *pointer;
+    typedef const K &reference;
+
+    explicit RankTreeIterator(RankTreeNode<K, T, B, S> *node = nullptr);
+
+    const K &operator*() const;
+
+    const K *operator->() const;
+
+    T *getData() const;
+
+    RankTreeIterator<K, T, isReverse, B, S> &operator++();
+
+    RankTreeIterator<K, T, isReverse, B, S> operator++(int);
+
+    bool operator==(const RankTreeIterator<K, T, isReverse, B, S> &other) const;
+
+    bool operator!=(const RankTreeIterator<K, T, isReverse, B, S> &other) const;
+};
+
+/**
+ * Creates an iterator pointing at a node, or at the first live node after it
+ * in the scan order if it's a tombstone
+ * @tparam K Class for node key comparisons
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param node The current node, nullptr for the end of the scan
+ */
+template<class K, class T, bool isReverse, class B, class S>
+RankTreeIterator<K, T, isReverse, B, S>::RankTreeIterator(RankTreeNode<K, T, B, S> *node): node(node) {
+    while (this->node && this->node->isDeleted) {
+        this->node = isReverse ? this->node->getPrevious() : this->node->getNext();
     }
-    int leftHeight = getLeftChildHeight();
-    int rightHeight = getRightChildHeight();
-    height = 1 + max(leftHeight, rightHeight);
 }
 
+template<class K, class T, bool isReverse, class B, class S>
+const K &RankTreeIterator<K, T, isReverse, B, S>::operator*() const {
+    return node->key;
+}
+
+template<class K, class T, bool isReverse, class B, class S>
+const K *RankTreeIterator<K, T, isReverse, B, S>::operator->() const {
+    return &node->key;
+}
+
+template<class K, class T, bool isReverse, class B, class S>
+T *RankTreeIterator<K, T, isReverse, B, S>::getData() const {
+    return node->getData();
+}
 
 /**
- * Generic Template Class for an AVL Tree
- * Stores and organizes AVL tree nodes meant to store dynamic user data
+ * Moves to the next live node in the scan order
+ * @tparam K Class for node key comparisons
  * @tparam T Pointer to dynamically allocated object of type T
+ * @return This iterator
  */
-template<class K, class T>
+template<class K, class T, bool isReverse, class B, class S>
+RankTreeIterator<K, T, isReverse, B, S> &RankTreeIterator<K, T, isReverse, B, S>::operator++() {
+    do {
+        node = isReverse ? node->getPrevious() : node->getNext();
+    } while (node && node->isDeleted);
+    return *this;
+}
+
+template<class K, class T, bool isReverse, class B, class S>
+RankTreeIterator<K, T, isReverse, B, S> RankTreeIterator<K, T, isReverse, B, S>::operator++(int) {
+    RankTreeIterator<K, T, isReverse, B, S> previous = *this;
+    ++*this;
+    return previous;
+}
+
+template<class K, class T, bool isReverse, class B, class S>
+bool RankTreeIterator<K, T, isReverse, B, S>::operator==(const RankTreeIterator<K, T, isReverse, B, S> &other) const {
+    return node == other.node;
+}
+
+template<class K, class T, bool isReverse, class B, class S>
+bool RankTreeIterator<K, T, isReverse, B, S>::operator!=(const RankTreeIterator<K, T, isReverse, B, S> &other) const {
+    return node != other.node;
+}
+
+/**
+ * Generic Template Class for a balanced rank tree, AVL unless another
+ * balancing policy is chosen
+ * Stores and organizes tree nodes meant to store dynamic user data
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @tparam B Balancing policy of the nodes (see BalancePolicy.h)
+ */
+template<class K, class T, class B = AvlBalance, class S = PointerStorage>
 class RankTree {
-    RankTreeNode<K, T> *root;
+public:
+    typedef typename S::template Pool<RankTreeNode<K, T, B, S>> NodePool;
+
+private:
+    RankTreeNode<K, T, B, S> *root;
+    NodePool *pool;
+    bool isUsingTombstones = false;
+
+    static RankTreeNode<K, T, B, S> *CreateAlmostCompleteTree(int numberOfNodes, NodePool *pool);
+
+    RankTree(RankTreeNode<K, T, B, S> *root, NodePool *pool, bool isUsingTombstones);
+
+    void Rebuild(const K *removedKeys, int numberOfRemoved, const K *insertedKeys, int numberOfInserted);
+
+    void CompactIfNeeded();
+
+    void CompactPathIfNeeded(RankTreeNode<K, T, B, S> *node);
 
 public:
-    RankTree();
+    typedef RankTreeIterator<K, T, false, B, S> Iterator;
+    typedef RankTreeIterator<K, T, true, B, S> ReverseIterator;
+
+    explicit RankTree(NodePool *pool = nullptr);
+
+    RankTree(int numberOfNodes, NodePool *pool = nullptr);
 
-    RankTree(int numberOfNodes);
+    RankTree(const K *keys, T **data, int numberOfNodes, NodePool *pool = nullptr);
 
-    RankTreeNode<K, T> *GetRoot();
+    RankTree(const K *keys, int numberOfNodes, NodePool *pool = nullptr);
+
+    RankTree(const RankTree<K, T, B, S> &other) = delete;
+
+    RankTree(RankTree<K, T, B, S> &&other) noexcept;
+
+    RankTree<K, T, B, S> &operator=(const RankTree<K, T, B, S> &other) = delete;
+
+    RankTree<K, T, B, S> &operator=(RankTree<K, T, B, S> &&other) noexcept;
+
+    RankTreeNode<K, T, B, S> *GetRoot();
 
     void MarkRootAsNullptr();
 
@@ -1037,22 +1427,56 @@ public:
 
     void FillRankTreeNodesWithArrData(T **&array, int size, int index = 0);
 
-    void FillArrWithNodesInOrder(RankTreeNode<K, T> **&array, int size, int index = 0);
+    void FillArrWithNodesInOrder(RankTreeNode<K, T, B, S> **&array, int size, int index = 0);
 
-    RankTreeNode<K, T> *Find(K key);
+    RankTreeNode<K, T, B, S> *Find(const K &key);
 
     K FindByRank(int searchRank);
 
-    void Insert(K key, T *data = nullptr);
+    void Insert(const K &key, T *data = nullptr);
 
-    RankTreeNode<K, T> *InsertGetBack(K key, T *data);
+    RankTreeNode<K, T, B, S> *InsertGetBack(const K &key, T *data);
 
     void PrintTreeWithRanks();
 
-    void Remove(K key);
+    void Remove(const K &key);
+
+    void ReplaceKeys(const K *removedKeys, int numberOfRemoved, const K *insertedKeys, int numberOfInserted);
+
+    void InsertBatch(const K *keys, int numberOfKeys);
+
+    void SetTombstoneMode(bool isUsingTombstones);
+
+    void Compact();
+
+    RankTree<K, T, B, S> Split(const K &key);
+
+    static RankTree<K, T, B, S> Join(RankTree<K, T, B, S> &left, RankTree<K, T, B, S> &right);
+
+    RankTree<K, T, B, S> ExtractRange(const K &from, const K &to);
+
+    void RemoveRange(const K &from, const K &to);
+
+    bool RelocateNodes(RelocationCursor<K> &cursor, int &budget);
 
     bool IsRootNull();
 
+    Iterator begin();
+
+    Iterator end();
+
+    ReverseIterator rbegin();
+
+    ReverseIterator rend();
+
+    Iterator IteratorFrom(const K &key);
+
+    ReverseIterator ReverseIteratorFrom(const K &key);
+
+    Iterator IteratorAtRank(int rank);
+
+    ReverseIterator ReverseIteratorAtRank(int rank);
+
     ~RankTree();
 
     void RankSanityCheck();
@@ -1067,9 +1491,54 @@ public:
 /**
  * Creates an empty AVL Tree to store nodes with type T
  * @tparam T Pointer to dynamically allocated object of type T
+ * @param pool The pool to allocate the nodes from
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::RankTree(NodePool *pool): root(nullptr), pool(pool) {};
+
+/**
+ * Creates a tree owning the nodes under the input root
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param root The root of the nodes, it's parent must be nullptr
+ * @param pool The pool the nodes were allocated from
+ * @param isUsingTombstones True if removals leave tombstones
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::RankTree(RankTreeNode<K, T, B, S> *root, NodePool *pool, bool isUsingTombstones):
+        root(root), pool(pool), isUsingTombstones(isUsingTombstones) {}
+
+/**
+ * Takes ownership of the nodes of another tree, leaving the other tree empty
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param other The tree to move the nodes from
  */
-template<class K, class T>
-RankTree<K, T>::RankTree(): root(nullptr) {};
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::RankTree(RankTree<K, T, B, S> &&other) noexcept:
+        root(other.root), pool(other.pool), isUsingTombstones(other.isUsingTombstones) {
+    other.root = nullptr;
+}
+
+/**
+ * Deletes the nodes of this tree and takes ownership of the nodes of another
+ * tree, leaving the other tree empty
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param other The tree to move the nodes from
+ * @return A reference to this tree
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S> &RankTree<K, T, B, S>::operator=(RankTree<K, T, B, S> &&other) noexcept {
+    if (this != &other) {
+        if (root) {
+            root->DeleteTreeData();
+            delete root;
+        }
+        root = other.root;
+        pool = other.pool;
+        isUsingTombstones = other.isUsingTombstones;
+        other.root = nullptr;
+    }
+    return *this;
+}
 
 
 /**
@@ -1077,8 +1546,8 @@ RankTree<K, T>::RankTree(): root(nullptr) {};
  * @tparam T Pointer to dynamically allocated object of type T
  * @return A pointer to the root of the tree
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTree<K, T>::GetRoot() {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTree<K, T, B, S>::GetRoot() {
     if (root) {
         return root;
     }
@@ -1089,15 +1558,17 @@ RankTreeNode<K, T> *RankTree<K, T>::GetRoot() {
  * Searches for a node by key in the tree and returns it if it exists
  * @tparam T Pointer to dynamically allocated object of type T
  * @param key The key of the node to find
- * @return A pointer to the node if it's found in the tree, nullptr otherwise
+ * @return A pointer to the node if it's found in the tree and isn't a
+ * tombstone, nullptr otherwise
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTree<K, T>::Find(K key) {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTree<K, T, B, S>::Find(const K &key) {
     if (!root) {
         return nullptr;
     }
 
-    return root->Find(key);
+    RankTreeNode<K, T, B, S> *node = root->Find(key);
+    return (node && !node->IsDeleted()) ? node : nullptr;
 }
 
 /**
@@ -1109,14 +1580,9 @@ RankTreeNode<K, T> *RankTree<K, T>::Find(K key) {
  * @param key The key of the new node
  * @param data The data of the new node
  */
-template<class K, class T>
-void RankTree<K, T>::Insert(K key, T *data) {
-    if (!root) {
-        // The tree is empty, inserting the new node as the root
-        root = new RankTreeNode<K, T>(key, data);
-    } else {
-        root = root->Insert(key, data);
-    }
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::Insert(const K &key, T *data) {
+    InsertGetBack(key, data);
 }
 
 /**
@@ -1127,29 +1593,440 @@ void RankTree<K, T>::Insert(K key, T *data) {
  * @param result A pointer to save a reference to the new node in
  * @return A pointer to the newely inserted ndoe
  */
-template<class K, class T>
-RankTreeNode<K, T> *RankTree<K, T>::InsertGetBack(K key, T *data) {
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTree<K, T, B, S>::InsertGetBack(const K &key, T *data) {
     if (!root) {
         // The tree is empty, inserting the new node as the root
-        root = new RankTreeNode<K, T>(key, data);
+        root = new (pool) RankTreeNode<K, T, B, S>(key, data);
         return root;
-    } else {
-        RankTreeNode<K, T> *result = nullptr;
-        root = root->Insert(key, data, result);
-        return result;
+    } else if (root->getSize() != root->getRank()) {
+        // A tombstone with the same key comes back to life in place
+        RankTreeNode<K, T, B, S> *node = root->Find(key);
+        if (node && node->IsDeleted()) {
+            node->Revive(data);
+            return node;
+        }
     }
+    RankTreeNode<K, T, B, S> *result = nullptr;
+    root = root->Insert(key, data, &result);
+    return result;
 }
 
 /**
  * Removes a node with the given key from the tree
+ * In tombstone mode the node is only marked as deleted, and a subtree above
+ * it where the tombstones passed rankTreeMaxTombstonePercent of the nodes is
+ * rebuilt without them
  * @tparam T Pointer to dynamically allocated object of type T
  * @param key The key of the node to remove
  */
-template<class K, class T>
-void RankTree<K, T>::Remove(K key) {
-    if (root) {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::Remove(const K &key) {
+    if (!root) {
+        return;
+    }
+    if (!isUsingTombstones) {
         root = root->Remove(key);
+        return;
+    }
+    RankTreeNode<K, T, B, S> *node = root->Find(key);
+    if (!node || node->IsDeleted()) {
+        return;
+    }
+    node->MarkDeleted();
+    CompactPathIfNeeded(node);
+}
+
+/**
+ * Removes and inserts many keys as one batch, the inserted keys get no data
+ * A small batch is applied key by key, a batch large enough compared to the
+ * tree merges the changes into the nodes of the tree in order and rebuilds
+ * it as an almost complete tree in O(size + batch) without any rotations
+ * The result is the same as removing all the removed keys and then inserting
+ * all the inserted keys
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param removedKeys The keys to remove, sorted
+ * @param numberOfRemoved The number of keys to remove
+ * @param insertedKeys The keys to insert, sorted
+ * @param numberOfInserted The number of keys to insert
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::ReplaceKeys(const K *removedKeys, int numberOfRemoved, const K *insertedKeys,
+                                    int numberOfInserted) {
+    int numberOfNodes = root ? root->getSize() : 0;
+    if ((long long) (numberOfRemoved + numberOfInserted) * rankTreeRebuildFactor < numberOfNodes) {
+        for (int i = 0; i < numberOfRemoved; ++i) {
+            Remove(removedKeys[i]);
+        }
+        for (int i = 0; i < numberOfInserted; ++i) {
+            Insert(insertedKeys[i]);
+        }
+        return;
+    }
+    Rebuild(removedKeys, numberOfRemoved, insertedKeys, numberOfInserted);
+}
+
+/**
+ * Inserts many keys as one batch, the inserted keys get no data and keys that
+ * already exist in the tree are ignored
+ * The batch is sorted and goes down the tree once, subtrees that get many of
+ * the keys are rebuilt in linear time instead of rotating per key
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param keys The keys to insert, in any order
+ * @param numberOfKeys The number of keys to insert
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::InsertBatch(const K *keys, int numberOfKeys) {
+    if (numberOfKeys <= 0) {
+        return;
+    }
+    K *sortedKeys = new K[numberOfKeys];
+    for (int i = 0; i < numberOfKeys; ++i) {
+        sortedKeys[i] = keys[i];
+    }
+    std::sort(sortedKeys, sortedKeys + numberOfKeys);
+    int numberOfUniqueKeys = (int) (std::unique(sortedKeys, sortedKeys + numberOfKeys, [](const K &a, const K &b) {
+        return !(a < b) && !(b < a);
+    }) - sortedKeys);
+    root = RankTreeNode<K, T, B, S>::InsertSorted(root, sortedKeys, numberOfUniqueKeys, pool);
+    delete[] sortedKeys;
+}
+
+/**
+ * Turns tombstone mode on or off, turning it off compacts the tree so no
+ * tombstones are left behind
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param isUsingTombstones True to leave tombstones on removals
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::SetTombstoneMode(bool isUsingTombstones) {
+    this->isUsingTombstones = isUsingTombstones;
+    if (!isUsingTombstones && root && root->getSize() != root->getRank()) {
+        Compact();
+    }
+}
+
+/**
+ * Compacts the tree if more than rankTreeMaxTombstonePercent of it's nodes
+ * are tombstones, which only a split can leave behind since removals compact
+ * the subtrees above them as they go
+ * @tparam T Pointer to dynamically allocated object of type T
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::CompactIfNeeded() {
+    if (!root) {
+        return;
+    }
+    long long numberOfTombstones = root->getSize() - root->getRank();
+    if (numberOfTombstones * 100 > (long long) root->getSize() * rankTreeMaxTombstonePercent) {
+        Compact();
+    }
+}
+
+/**
+ * Rebuilds the highest subtree on the path from the root to a new tombstone
+ * where more than rankTreeMaxTombstonePercent of the nodes are tombstones
+ * The rebuild costs O(size) for a subtree with at least size / 2 tombstones,
+ * and every tombstone is deleted by one rebuild, so removals pay O(1) amortized
+ * for the restructuring on top of the O(log n) walk and join
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param node The new tombstone
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::CompactPathIfNeeded(RankTreeNode<K, T, B, S> *node) {
+    RankTreeNode<K, T, B, S> *highest = nullptr;
+    for (; node; node = node->getParent()) {
+        long long numberOfTombstones = node->getSize() - node->getRank();
+        if (numberOfTombstones * 100 > (long long) node->getSize() * rankTreeMaxTombstonePercent) {
+            highest = node;
+        }
+    }
+    if (highest) {
+        root = RankTreeNode<K, T, B, S>::CompactSubtree(highest, pool);
+    }
+}
+
+/**
+ * Rebuilds the tree from it's live nodes as an almost complete tree in O(n),
+ * deleting all the tombstones
+ * @tparam T Pointer to dynamically allocated object of type T
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::Compact() {
+    Rebuild(nullptr, 0, nullptr, 0);
+}
+
+/**
+ * Merges sorted changes into the live nodes of the tree in order and rebuilds
+ * it as an almost complete tree in O(size + changes) without any rotations,
+ * tombstones are dropped on the way
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param removedKeys The keys to remove, sorted
+ * @param numberOfRemoved The number of keys to remove
+ * @param insertedKeys The keys to insert, sorted
+ * @param numberOfInserted The number of keys to insert
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::Rebuild(const K *removedKeys, int numberOfRemoved, const K *insertedKeys,
+                                int numberOfInserted) {
+    int numberOfNodes = root ? root->getSize() : 0;
+    RankTreeNode<K, T, B, S> **nodes = new RankTreeNode<K, T, B, S> *[numberOfNodes + 1];
+    RankTreeNode<K, T, B, S> **nodesArray = nodes;
+    FillArrWithNodesInOrder(nodesArray, numberOfNodes);
+    root = nullptr;
+
+    K *keys = new K[numberOfNodes + numberOfInserted];
+    T **data = new T *[numberOfNodes + numberOfInserted];
+    int size = 0;
+    int oldIndex = 0;
+    int removedIndex = 0;
+    int insertedIndex = 0;
+    while (oldIndex < numberOfNodes || insertedIndex < numberOfInserted) {
+        if (insertedIndex == numberOfInserted ||
+            (oldIndex < numberOfNodes && !(insertedKeys[insertedIndex] < nodes[oldIndex]->getKey()))) {
+            RankTreeNode<K, T, B, S> *node = nodes[oldIndex];
+            while (removedIndex < numberOfRemoved && removedKeys[removedIndex] < node->getKey()) {
+                removedIndex++;
+            }
+            if (!node->IsDeleted() &&
+                (removedIndex == numberOfRemoved || node->getKey() < removedKeys[removedIndex])) {
+                // The node is kept, it's data moves to the new tree
+                keys[size] = node->getKey();
+                data[size++] = node->getData();
+                node->removeDataPointer();
+            }
+            delete node;
+            oldIndex++;
+        } else {
+            // An inserted key that already exists is ignored, like in Insert
+            if (size == 0 || keys[size - 1] < insertedKeys[insertedIndex]) {
+                keys[size] = insertedKeys[insertedIndex];
+                data[size++] = nullptr;
+            }
+            insertedIndex++;
+        }
+    }
+    delete[] nodes;
+    root = CreateAlmostCompleteTree(size, pool);
+    const K *keysArray = keys;
+    T **dataArray = data;
+    RankTreeNode<K, T, B, S>::FillKeysAndDataInOrder(root, keysArray, dataArray);
+    delete[] keys;
+    delete[] data;
+}
+
+/**
+ * Splits the tree at a key in O(log n), the tree keeps the keys smaller than
+ * the input key and the rest of the nodes move to the returned tree
+ * Nodes keep their data and no node is allocated or deleted, unless a side is
+ * left with too many tombstones and is compacted
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param key The key to split at
+ * @return A tree with the keys not smaller than the input key
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S> RankTree<K, T, B, S>::Split(const K &key) {
+    RankTreeNode<K, T, B, S> *notSmaller;
+    RankTreeNode<K, T, B, S>::Split(root, key, &root, &notSmaller);
+    // Either side may be left with mostly tombstones
+    CompactIfNeeded();
+    RankTree<K, T, B, S> greater(notSmaller, pool, isUsingTombstones);
+    greater.CompactIfNeeded();
+    return greater;
+}
+
+/**
+ * Joins two trees in O(log n), every key of the left tree must be smaller than
+ * every key of the right tree
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param left The tree with the smaller keys, left empty
+ * @param right The tree with the greater keys, left empty
+ * @return A tree with the nodes of both trees
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S> RankTree<K, T, B, S>::Join(RankTree<K, T, B, S> &left, RankTree<K, T, B, S> &right) {
+    RankTreeNode<K, T, B, S> *joined = RankTreeNode<K, T, B, S>::Join(left.root, right.root);
+    left.root = nullptr;
+    right.root = nullptr;
+    return RankTree<K, T, B, S>(joined, left.pool, left.isUsingTombstones);
+}
+
+/**
+ * Moves the nodes with keys in [from, to) to a new tree in O(log n) by two
+ * splits and a join, the nodes are not rebalanced one by one
+ * An empty range is found by a single search and leaves the tree untouched
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param from The minimal key of the range
+ * @param to The key right after the range
+ * @return A tree with the nodes of the range
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S> RankTree<K, T, B, S>::ExtractRange(const K &from, const K &to) {
+    Iterator first = IteratorFrom(from);
+    if (first == end() || !(*first < to)) {
+        return RankTree<K, T, B, S>(pool);
+    }
+    RankTree<K, T, B, S> range = Split(from);
+    RankTree<K, T, B, S> greater = range.Split(to);
+    root = RankTreeNode<K, T, B, S>::Join(root, greater.root);
+    greater.root = nullptr;
+    CompactIfNeeded();
+    return range;
+}
+
+/**
+ * Removes the nodes with keys in [from, to) and their data in O(log n + k)
+ * for k removed nodes
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param from The minimal key of the range
+ * @param to The key right after the range
+ */
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::RemoveRange(const K &from, const K &to) {
+    ExtractRange(from, to);
+}
+
+/**
+ * Moves the nodes and their data to the lowest free slots of their arenas in
+ * ascending key order, so the nodes that move end up in dense in order runs
+ * Tombstones are moved like live nodes
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param cursor The position of the pass in this tree, updated when the
+ * budget runs out and reset when the pass reaches the end of the tree
+ * @param budget The number of nodes this slice may still visit, decreased
+ * by the nodes visited
+ * @return True if the pass reached the end of the tree
+ */
+template<class K, class T, class B, class S>
+bool RankTree<K, T, B, S>::RelocateNodes(RelocationCursor<K> &cursor, int &budget) {
+    RankTreeNode<K, T, B, S> *node = root ? root->findMin() : nullptr;
+    if (cursor.isStarted) {
+        // Resuming at the first node not smaller than the cursor
+        RankTreeNode<K, T, B, S> *current = root;
+        node = nullptr;
+        while (current) {
+            if (current->getKey() < cursor.nextKey) {
+                current = current->getRight();
+            } else {
+                node = current;
+                current = current->getLeft();
+            }
+        }
     }
+    while (node) {
+        if (budget <= 0) {
+            cursor.nextKey = node->getKey();
+            cursor.isStarted = true;
+            return false;
+        }
+        budget--;
+        node = RankTreeNode<K, T, B, S>::Relocate(node);
+        if (!node->getParent()) {
+            root = node;
+        }
+        node = node->getNext();
+    }
+    cursor = RelocationCursor<K>();
+    return true;
+}
+
+/**
+ * Returns an iterator over the tree in ascending key order
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @return An iterator pointing at the minimal key
+ */
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::Iterator RankTree<K, T, B, S>::begin() {
+    return Iterator(root ? root->findMin() : nullptr);
+}
+
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::Iterator RankTree<K, T, B, S>::end() {
+    return Iterator();
+}
+
+/**
+ * Returns an iterator over the tree in descending key order, which is the
+ * order of increasing rank
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @return An iterator pointing at the maximal key
+ */
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::ReverseIterator RankTree<K, T, B, S>::rbegin() {
+    return ReverseIterator(root ? root->findMaxNoRank() : nullptr);
+}
+
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::ReverseIterator RankTree<K, T, B, S>::rend() {
+    return ReverseIterator();
+}
+
+/**
+ * Returns an iterator in ascending key order starting at a key
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param key The key to start from
+ * @return An iterator pointing at the first key not smaller than the input key
+ */
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::Iterator RankTree<K, T, B, S>::IteratorFrom(const K &key) {
+    RankTreeNode<K, T, B, S> *current = root;
+    RankTreeNode<K, T, B, S> *found = nullptr;
+    while (current) {
+        if (current->getKey() < key) {
+            current = current->getRight();
+        } else {
+            found = current;
+            current = current->getLeft();
+        }
+    }
+    return Iterator(found);
+}
+
+/**
+ * Returns an iterator in descending key order starting at a key
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param key The key to start from
+ * @return An iterator pointing at the last key not greater than the input key
+ */
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::ReverseIterator RankTree<K, T, B, S>::ReverseIteratorFrom(const K &key) {
+    RankTreeNode<K, T, B, S> *current = root;
+    RankTreeNode<K, T, B, S> *found = nullptr;
+    while (current) {
+        if (key < current->getKey()) {
+            current = current->getLeft();
+        } else {
+            found = current;
+            current = current->getRight();
+        }
+    }
+    return ReverseIterator(found);
+}
+
+/**
+ * Returns an iterator in ascending key order, which is the order of
+ * decreasing rank, starting at a rank
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param rank The rank to start from, where the maximal key has rank 1
+ * @return An iterator pointing at the key with the input rank, end() if there
+ * is no such rank
+ */
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::Iterator RankTree<K, T, B, S>::IteratorAtRank(int rank) {
+    return Iterator(RankTreeNode<K, T, B, S>::FindNodeAtRank(root, rank));
+}
+
+/**
+ * Returns an iterator in descending key order, which is the order of
+ * increasing rank, starting at a rank
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param rank The rank to start from, where the maximal key has rank 1
+ * @return An iterator pointing at the key with the input rank, rend() if there
+ * is no such rank
+ */
+template<class K, class T, class B, class S>
+typename RankTree<K, T, B, S>::ReverseIterator RankTree<K, T, B, S>::ReverseIteratorAtRank(int rank) {
+    return ReverseIterator(RankTreeNode<K, T, B, S>::FindNodeAtRank(root, rank));
 }
 
 /**
@@ -1157,8 +2034,8 @@ void RankTree<K, T>::Remove(K key) {
  * @tparam T Pointer to dynamically allocated object of type T
  * @return True if the root of the tree is a nullptr, False otherwiese
  */
-template<class K, class T>
-bool RankTree<K, T>::IsRootNull() {
+template<class K, class T, class B, class S>
+bool RankTree<K, T, B, S>::IsRootNull() {
     return (root == nullptr);
 }
 
@@ -1166,8 +2043,8 @@ bool RankTree<K, T>::IsRootNull() {
  * Marks the root of the tree as nullptr
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-void RankTree<K, T>::MarkRootAsNullptr() {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::MarkRootAsNullptr() {
     root = nullptr;
 }
 
@@ -1175,8 +2052,8 @@ void RankTree<K, T>::MarkRootAsNullptr() {
  * Marks the data of the root of the tree as nullptr
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-void RankTree<K, T>::MarkRootDataAsNullptr() {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::MarkRootDataAsNullptr() {
     root->removeDataPointer();
 }
 
@@ -1185,8 +2062,8 @@ void RankTree<K, T>::MarkRootDataAsNullptr() {
  * and then sets the root of the tree to nullptr
  * @tparam T Pointer to dynamically allocated object of type T
  */
-template<class K, class T>
-RankTree<K, T>::~RankTree() {
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::~RankTree() {
     if (root) {
         root->DeleteTreeData();
         delete root;
@@ -1203,8 +2080,8 @@ RankTree<K, T>::~RankTree() {
  * @param size The size of the array
  * @param index The current insertion position
  */
-template<class K, class T>
-void RankTree<K, T>::FillRankTreeNodesWithArrData(T **&array, int size, int index) {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::FillRankTreeNodesWithArrData(T **&array, int size, int index) {
     if (!root) {
         // Tree is empty, no nodes to save data in
         return;
@@ -1221,8 +2098,8 @@ void RankTree<K, T>::FillRankTreeNodesWithArrData(T **&array, int size, int inde
  * @param size The size of the array
  * @param index The current insertion position
  */
-template<class K, class T>
-void RankTree<K, T>::FillArrWithNodesInOrder(RankTreeNode<K, T> **&array, int size, int index) {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::FillArrWithNodesInOrder(RankTreeNode<K, T, B, S> **&array, int size, int index) {
     if (!root) {
         // Tree is empty, no nodes to get back
         return;
@@ -1232,51 +2109,84 @@ void RankTree<K, T>::FillArrWithNodesInOrder(RankTreeNode<K, T> **&array, int si
 }
 
 /**
- * Creates a new almost complete binary tree according to the input parameters
+ * Creates the nodes of an almost complete binary tree, the keys and data of
+ * the nodes are left for the caller to fill
  * @tparam T Pointer to dynamically allocated object of type T
- * @param root The key of the trees' root
- * @param maxHeight The height ot the trees' root
- * @param maxNode the key of the highest node
- */
-template<class K, class T>
-RankTree<K, T>::RankTree(int numberOfNodes) {
-    // Calculating the height of the tree
-    int treeLevel = ceil(log2(numberOfNodes));
-    if (treeLevel == log2(numberOfNodes)) {
-        // The number of nodes is a power of two, need to increase it by one
-        // to create a real complete binary tree
-        treeLevel++;
-    }
-    // Creating the root of the complete tree
-    root = new RankTreeNode<K, T>(0, nullptr, nullptr);
-    RankTreeNode<K, T>::CreateCompleteBinaryTree(root, treeLevel, 1);
-
-    // After creating the complete binary tree, we need to remove extra nodes
-    // that are unnecessary
-    int numberOfNodesToRemove = (int) (pow(2, treeLevel) - 1) - numberOfNodes;
-    if (treeLevel != 0) {
-        // The tree has more than one floor, meaning we need to remove a few of
-        // the nodes
-        RankTreeNode<K, T>::RemoveExtraNodes(root, numberOfNodesToRemove);
+ * @param numberOfNodes The number of nodes in the tree
+ * @param pool The pool to allocate the nodes from
+ * @return The root of the new tree, nullptr if there are no nodes
+ */
+template<class K, class T, class B, class S>
+RankTreeNode<K, T, B, S> *RankTree<K, T, B, S>::CreateAlmostCompleteTree(int numberOfNodes, NodePool *pool) {
+    if (numberOfNodes <= 0) {
+        return nullptr;
+    }
+    // The nodes are allocated in order, so an in order scan of the new tree
+    // walks through memory in order too
+    RankTreeNode<K, T, B, S> **nodes = new RankTreeNode<K, T, B, S> *[numberOfNodes];
+    for (int i = 0; i < numberOfNodes; ++i) {
+        nodes[i] = new (pool) RankTreeNode<K, T, B, S>(K());
     }
+    RankTreeNode<K, T, B, S> *newRoot = RankTreeNode<K, T, B, S>::LinkBalanced(nodes, numberOfNodes);
+    delete[] nodes;
+    return newRoot;
+}
+
+/**
+ * Creates a new almost complete binary tree according to the input parameters
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param numberOfNodes The number of nodes in the tree, keyed from K() upwards
+ * @param pool The pool to allocate the nodes from
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::RankTree(int numberOfNodes, NodePool *pool): pool(pool) {
+    root = CreateAlmostCompleteTree(numberOfNodes, pool);
     K key = K();
-    RankTreeNode<K, T>::FillKeysInOrder(root, key);
+    RankTreeNode<K, T, B, S>::FillKeysInOrder(root, key);
+}
+
+/**
+ * Creates a tree holding the input keys in O(numberOfNodes), the shape of the
+ * tree is built balanced up front so no rotations are needed
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param keys The keys of the tree, sorted and without duplicates
+ * @param data The data of every key, the tree takes ownership of it
+ * @param numberOfNodes The number of keys
+ * @param pool The pool to allocate the nodes from
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::RankTree(const K *keys, T **data, int numberOfNodes, NodePool *pool): pool(pool) {
+    root = CreateAlmostCompleteTree(numberOfNodes, pool);
+    RankTreeNode<K, T, B, S>::FillKeysAndDataInOrder(root, keys, data);
+}
+
+/**
+ * Creates a tree holding the input keys with no data in O(numberOfNodes), for
+ * trees that are sets of keys
+ * @tparam T Pointer to dynamically allocated object of type T
+ * @param keys The keys of the tree, sorted and without duplicates
+ * @param numberOfNodes The number of keys
+ * @param pool The pool to allocate the nodes from
+ */
+template<class K, class T, class B, class S>
+RankTree<K, T, B, S>::RankTree(const K *keys, int numberOfNodes, NodePool *pool): pool(pool) {
+    root = RankTreeNode<K, T, B, S>::InsertSorted(nullptr, keys, numberOfNodes, pool);
 }
 
-template<class K, class T>
-K RankTree<K, T>::FindByRank(int searchRank) {
-    return RankTreeNode<K, T>::FindNodeByRank(root, searchRank);
+template<class K, class T, class B, class S>
+K RankTree<K, T, B, S>::FindByRank(int searchRank) {
+    return RankTreeNode<K, T, B, S>::FindNodeByRank(root, searchRank);
 }
 
-template<class K, class T>
-void RankTree<K, T>::PrintTreeWithRanks() {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::PrintTreeWithRanks() {
     if (root) {
         root->PrintTreeInOrderWithRanks();
     }
 }
 
-template<class K, class T>
-void RankTree<K, T>::RankSanityCheck() {
+template<class K, class T, class B, class S>
+void RankTree<K, T, B, S>::RankSanityCheck() {
     if (root) {
         root->RankSanity();
     }
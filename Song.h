@@ -6,19 +6,29 @@
 #define WET2_SONG_H
 
 
-#include "Tree.h"
-#include "RankTree.h"
-#include "ThreeParamKey.h"
-
-class Song {
+#include "NodeStorage.h"
+
+/**
+ * The songs and the nodes of the trees of the library live in arenas owned by
+ * their music manager, the trees link their nodes by 32 bit indices and freed
+ * slots are reused, unless
+ * WET2_POINTER_NODES selects objects allocated one by one and linked by
+ * pointers
+ */
+#ifdef WET2_POINTER_NODES
+typedef PointerStorage LibraryNodeStorage;
+#else
+typedef ArenaStorage LibraryNodeStorage;
+#endif
+
+class Song : public LibraryNodeStorage::NodeBase<Song> {
 private:
     int songID;
     int artistID;
     int numberOfPlays;
-    RankTreeNode<ThreeParamKey, int> *ptrToRankedSong;
 
 public:
-    Song(int songID, int artistID, int numberOfPlays = 0, RankTreeNode<ThreeParamKey, int> *ptrToRanked = nullptr);
+    Song(int songID, int artistID, int numberOfPlays = 0);
 
     int getSongId() const;
 
@@ -32,10 +42,6 @@ public:
 
     void setNumberOfPlays(int nNumberOfPlays);
 
-    RankTreeNode<ThreeParamKey, int> *getPtrToRankedSong() const;
-
-    void setPtrToRankedSong(RankTreeNode<ThreeParamKey, int> *nPtr);
-
     ~Song() = default;
 };
 
@@ -4,79 +4,32 @@
 
 #include "ThreeParamKey.h"
 
-ThreeParamKey::ThreeParamKey() : numberOfPlays(0), songID(1), artistID(1) {
-
-}
-
-ThreeParamKey::ThreeParamKey(int numberOfPlays, int songId, int artistId) : numberOfPlays(numberOfPlays), songID(songId), artistID(artistId) {
-
-}
-
-bool ThreeParamKey::operator==(const ThreeParamKey &other) {
-    return (numberOfPlays == other.numberOfPlays) && (songID == other.songID) && (artistID == other.artistID);
-}
-
-bool ThreeParamKey::operator!=(const ThreeParamKey &other) {
-    return !(operator==(other));
-}
-
-bool ThreeParamKey::operator>(const ThreeParamKey &other) {
-    if (numberOfPlays == other.numberOfPlays) {
-        if (artistID == other.artistID) {
-            return (songID < other.songID);
-        } else {
-            return (artistID < other.artistID);
-        }
-    } else {
-        return (numberOfPlays > other.numberOfPlays);
-    }
-}
-
-bool ThreeParamKey::operator>=(const ThreeParamKey &other) {
-    return (operator>(other) || operator==(other));
-}
-
-bool ThreeParamKey::operator<(const ThreeParamKey &other) {
-    if (numberOfPlays == other.numberOfPlays) {
-        if (artistID == other.artistID) {
-            return (songID > other.songID);
-        } else {
-            return (artistID > other.artistID);
-        }
-    } else {
-        return (numberOfPlays < other.numberOfPlays);
-    }
-}
-
-bool ThreeParamKey::operator<=(const ThreeParamKey &other) {
-    return (operator<(other) || operator==(other));
-}
-
 int ThreeParamKey::getNumberOfPlays() const {
-    return numberOfPlays;
+    return FromOrderedBits(packedPlays);
 }
 
 void ThreeParamKey::setNumberOfPlays(int nNumPlays) {
-    ThreeParamKey::numberOfPlays = nNumPlays;
+    packedPlays = OrderedBits(nNumPlays);
 }
 
 int ThreeParamKey::getSongId() const {
-    return songID;
+    return FromOrderedBits(~packedSongID);
 }
 
 void ThreeParamKey::setSongId(int nSongID) {
-    ThreeParamKey::songID = nSongID;
+    packedSongID = ~OrderedBits(nSongID);
 }
 
 int ThreeParamKey::getArtistId() const {
-    return artistID;
+    return FromOrderedBits(~packedArtistID);
 }
 
 void ThreeParamKey::setArtistId(int nArtistID) {
-    ThreeParamKey::artistID = nArtistID;
+    packedArtistID = ~OrderedBits(nArtistID);
 }
 
 std::ostream &operator<<(std::ostream &os, const ThreeParamKey &key) {
-    os << "numPlays: " << key.numberOfPlays << " artistID: " << key.artistID << " songID: " << key.songID << std::endl;
+    os << "numPlays: " << key.getNumberOfPlays() << " artistID: " << key.getArtistId() << " songID: " << key.getSongId()
+       << std::endl;
     return os;
 }
\ No newline at end of file
@@ -7,17 +7,30 @@
 
 
 #include <ostream>
-
+#include "KeyCompare.h"
+
+/**
+ * The key of a song in the global ranking, ordered by the number of plays,
+ * then by the artist ID and then by the song ID, where a higher ID is a
+ * smaller key
+ * The fields are kept in their packed form, the number of plays and the
+ * artist ID make the high 64 bits and the song ID the low 32 bits of one
+ * order preserving integer, so comparing two keys compares two integers
+ */
 class ThreeParamKey {
 private:
-    int numberOfPlays = 0;
-    int songID = 1;
-    int artistID = 1;
+    unsigned int packedPlays;
+    unsigned int packedArtistID;
+    unsigned int packedSongID;
 
-public:
-    ThreeParamKey();
+    constexpr unsigned long long getHighBits() const {
+        return ((unsigned long long) packedPlays << 32u) | packedArtistID;
+    }
 
-    ThreeParamKey(int numberOfPlays = 0, int songId = 1, int artistId = 1);
+public:
+    constexpr ThreeParamKey(int numberOfPlays = 0, int songId = 1, int artistId = 1) :
+            packedPlays(OrderedBits(numberOfPlays)), packedArtistID(~OrderedBits(artistId)),
+            packedSongID(~OrderedBits(songId)) {}
 
     int getNumberOfPlays() const;
 
@@ -31,17 +44,38 @@ public:
 
     void setArtistId(int nArtistID);
 
-    bool operator==(const ThreeParamKey &other);
-
-    bool operator!=(const ThreeParamKey &other);
-
-    bool operator>(const ThreeParamKey &other);
-
-    bool operator>=(const ThreeParamKey &other);
-
-    bool operator<(const ThreeParamKey &other);
-
-    bool operator<=(const ThreeParamKey &other);
+    /**
+     * @return A negative number, 0 or a positive number if first is smaller,
+     * equal or greater than second
+     */
+    friend constexpr int CompareKeys(const ThreeParamKey &first, const ThreeParamKey &second) {
+        return 2 * CompareBits(first.getHighBits(), second.getHighBits()) +
+               CompareBits(first.packedSongID, second.packedSongID);
+    }
+
+    bool operator==(const ThreeParamKey &other) const {
+        return getHighBits() == other.getHighBits() && packedSongID == other.packedSongID;
+    }
+
+    bool operator!=(const ThreeParamKey &other) const {
+        return !(operator==(other));
+    }
+
+    bool operator>(const ThreeParamKey &other) const {
+        return CompareKeys(*this, other) > 0;
+    }
+
+    bool operator>=(const ThreeParamKey &other) const {
+        return CompareKeys(*this, other) >= 0;
+    }
+
+    bool operator<(const ThreeParamKey &other) const {
+        return CompareKeys(*this, other) < 0;
+    }
+
+    bool operator<=(const ThreeParamKey &other) const {
+        return CompareKeys(*this, other) <= 0;
+    }
 
     friend std::ostream &operator<<(std::ostream &os, const ThreeParamKey &key);
 };
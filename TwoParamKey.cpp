@@ -4,58 +4,18 @@
 
 #include "TwoParamKey.h"
 
-TwoParamKey::TwoParamKey() : numberOfPlays(0), songID(1) {
-
-}
-
-TwoParamKey::TwoParamKey(int numberOfPlays, int songID) : numberOfPlays(numberOfPlays), songID(songID) {
-
-}
-
-bool TwoParamKey::operator==(const TwoParamKey &other) {
-    return (numberOfPlays == other.numberOfPlays) && (songID == other.songID);
-}
-
-bool TwoParamKey::operator!=(const TwoParamKey &other) {
-    return !(operator==(other));
-}
-
-bool TwoParamKey::operator>(const TwoParamKey &other) {
-    if (numberOfPlays == other.numberOfPlays) {
-        return (songID < other.songID);
-    } else {
-        return (numberOfPlays > other.numberOfPlays);
-    }
-}
-
-bool TwoParamKey::operator>=(const TwoParamKey &other) {
-    return (operator>(other) || operator==(other));
-}
-
-bool TwoParamKey::operator<(const TwoParamKey &other) {
-    if (numberOfPlays == other.numberOfPlays) {
-        return (songID > other.songID);
-    } else {
-        return (numberOfPlays < other.numberOfPlays);
-    }
-}
-
-bool TwoParamKey::operator<=(const TwoParamKey &other) {
-    return (operator<(other) || operator==(other));
-}
-
 int TwoParamKey::getNumberOfPlays() const {
-    return numberOfPlays;
+    return FromOrderedBits((unsigned int) (packed >> 32u));
 }
 
 void TwoParamKey::setNumberOfPlays(int nNumPlays) {
-    TwoParamKey::numberOfPlays = nNumPlays;
+    packed = ((unsigned long long) OrderedBits(nNumPlays) << 32u) | (packed & 0xFFFFFFFFull);
 }
 
 int TwoParamKey::getSongId() const {
-    return songID;
+    return FromOrderedBits(~(unsigned int) packed);
 }
 
 void TwoParamKey::setSongId(int nSongID) {
-    TwoParamKey::songID = nSongID;
+    packed = (packed & ~0xFFFFFFFFull) | ~OrderedBits(nSongID);
 }
\ No newline at end of file
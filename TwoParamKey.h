@@ -6,15 +6,21 @@
 #define WET2_TWOPARAMKEY_H
 
 
+#include "KeyCompare.h"
+
+/**
+ * The key of a song in the ranking of it's artist, ordered by the number of
+ * plays and then by the song ID, where a higher ID is a smaller key
+ * The key is kept as one order preserving 64 bit integer, the number of plays
+ * in the high bits and the song ID in the low bits
+ */
 class TwoParamKey {
 private:
-    int numberOfPlays = 0;
-    int songID = 1;
+    unsigned long long packed;
 
 public:
-    TwoParamKey();
-
-    TwoParamKey(int numberOfPlays = 0, int songID = 1);
+    constexpr TwoParamKey(int numberOfPlays = 0, int songID = 1) :
+            packed(((unsigned long long) OrderedBits(numberOfPlays) << 32u) | ~OrderedBits(songID)) {}
 
     int getNumberOfPlays() const;
 
@@ -24,17 +30,37 @@ public:
 
     void setSongId(int nSongID);
 
-    bool operator==(const TwoParamKey &other);
-
-    bool operator!=(const TwoParamKey &other);
-
-    bool operator>(const TwoParamKey &other);
-
-    bool operator>=(const TwoParamKey &other);
-
-    bool operator<(const TwoParamKey &other);
-
-    bool operator<=(const TwoParamKey &other);
+    /**
+     * @return A negative number, 0 or a positive number if first is smaller,
+     * equal or greater than second
+     */
+    friend constexpr int CompareKeys(const TwoParamKey &first, const TwoParamKey &second) {
+        return CompareBits(first.packed, second.packed);
+    }
+
+    bool operator==(const TwoParamKey &other) const {
+        return packed == other.packed;
+    }
+
+    bool operator!=(const TwoParamKey &other) const {
+        return packed != other.packed;
+    }
+
+    bool operator>(const TwoParamKey &other) const {
+        return packed > other.packed;
+    }
+
+    bool operator>=(const TwoParamKey &other) const {
+        return packed >= other.packed;
+    }
+
+    bool operator<(const TwoParamKey &other) const {
+        return packed < other.packed;
+    }
+
+    bool operator<=(const TwoParamKey &other) const {
+        return packed <= other.packed;
+    }
 };
 
 
@@ -0,0 +1,78 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+// Feeds HashTable artist IDs crafted to collide under the fixed Fibonacci
+// multiplier and compares the per-key cost with the per-instance seeded hash
+// usage: ./adversarial_hash_benchmark [number of keys]
+
+#include "../HashTable.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Collects positive IDs whose Fibonacci hash has it's top 12 bits cleared,
+ * every such ID starts probing at the same group in any table of up to 4096
+ * groups, which is what an attacker who knows the multiplier would send
+ */
+static vector<int> AdversarialKeys(int numberOfKeys) {
+    vector<int> keys;
+    FibonacciHash hash;
+    for (int key = 1; (int) keys.size() < numberOfKeys && key < 0x7FFFFFFF; ++key) {
+        if ((hash(key) >> 52) == 0) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+template<class H>
+static void Benchmark(const char *name, const char *keysName, const vector<int> &keys) {
+    HashTable<int, H> table;
+    auto start = std::chrono::steady_clock::now();
+    for (int key : keys) {
+        table.Insert(key, int(key));
+    }
+    double insertMs = ElapsedMs(start);
+
+    long long found = 0;
+    start = std::chrono::steady_clock::now();
+    for (int key : keys) {
+        found += *table.FindData(key);
+    }
+    double findMs = ElapsedMs(start);
+    printf("%-14s %-11s insert: %10.2f ns/key, find: %10.2f ns/key (checksum %lld)\n", name, keysName,
+           insertMs * 1e6 / keys.size(), findMs * 1e6 / keys.size(), found);
+}
+
+int main(int argc, const char **argv) {
+    int numberOfKeys = 50000;
+    if (argc > 1) {
+        numberOfKeys = atoi(argv[1]);
+    }
+
+    vector<int> adversarial = AdversarialKeys(numberOfKeys);
+    vector<int> random(adversarial.size());
+    std::mt19937 generator(2020);
+    for (size_t i = 0; i < random.size(); ++i) {
+        random[i] = (int) (i * 40000 + generator() % 40000 + 1);
+    }
+    std::shuffle(random.begin(), random.end(), generator);
+    printf("%zu keys\n", adversarial.size());
+
+    Benchmark<FibonacciHash>("FibonacciHash", "random", random);
+    Benchmark<FibonacciHash>("FibonacciHash", "adversarial", adversarial);
+    Benchmark<SeededHash>("SeededHash", "random", random);
+    Benchmark<SeededHash>("SeededHash", "adversarial", adversarial);
+    return 0;
+}
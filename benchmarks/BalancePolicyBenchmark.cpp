@@ -0,0 +1,120 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+// Compares the balancing policies of RankTree on the operations of the library,
+// mostly AddToSongCount which moves a song in the global ranking and in the
+// ranking of it's artist
+// usage: ./balance_policy_benchmark [number of songs] [number of operations] [number of artists]
+
+#include "../RankTree.h"
+#include "../ThreeParamKey.h"
+#include "../TwoParamKey.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct SongState {
+    int artistID;
+    int plays;
+};
+
+template<class N>
+static int Height(N *node) {
+    if (!node) {
+        return 0;
+    }
+    return 1 + std::max(Height(node->getLeft()), Height(node->getRight()));
+}
+
+template<class B>
+static void Benchmark(const char *name, vector<SongState> songs, int numberOfArtists, const vector<int> &operations,
+                      const vector<int> &targets) {
+    RankTree<ThreeParamKey, int, B> ranking;
+    vector<RankTree<TwoParamKey, int, B>> artistRankings(numberOfArtists);
+    int numberOfSongs = (int) songs.size();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numberOfSongs; ++i) {
+        ranking.Insert(ThreeParamKey(0, i + 1, songs[i].artistID), nullptr);
+        artistRankings[songs[i].artistID].Insert(TwoParamKey(0, i + 1), nullptr);
+    }
+    double buildMs = ElapsedMs(start);
+
+    long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < (int) operations.size(); ++i) {
+        int target = targets[i];
+        if (operations[i] == 0) {
+            // AddToSongCount
+            SongState &song = songs[target];
+            int count = 1 + i % 5;
+            ranking.Remove(ThreeParamKey(song.plays, target + 1, song.artistID));
+            ranking.Insert(ThreeParamKey(song.plays + count, target + 1, song.artistID), nullptr);
+            RankTree<TwoParamKey, int, B> &artistRanking = artistRankings[song.artistID];
+            artistRanking.Remove(TwoParamKey(song.plays, target + 1));
+            artistRanking.Insert(TwoParamKey(song.plays + count, target + 1), nullptr);
+            song.plays += count;
+        } else if (operations[i] == 1) {
+            // GetRecommendedSongInPlace
+            checksum += ranking.FindByRank(1 + target).getSongId();
+        } else {
+            // AddSong
+            int artistID = target % numberOfArtists;
+            songs.push_back(SongState{artistID, 0});
+            int songID = (int) songs.size();
+            ranking.Insert(ThreeParamKey(0, songID, artistID), nullptr);
+            artistRankings[artistID].Insert(TwoParamKey(0, songID), nullptr);
+        }
+    }
+    double operationsMs = ElapsedMs(start);
+
+    printf("%-10s build: %7.1f ns/song, operations: %7.1f ns/op, ranking height %d (checksum %lld)\n", name,
+           buildMs * 1e6 / numberOfSongs, operationsMs * 1e6 / operations.size(), Height(ranking.GetRoot()), checksum);
+}
+
+int main(int argc, const char **argv) {
+    int numberOfSongs = 1000000;
+    int numberOfOperations = 2000000;
+    int numberOfArtists = 10000;
+    if (argc > 1) {
+        numberOfSongs = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        numberOfOperations = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        numberOfArtists = atoi(argv[3]);
+    }
+
+    std::mt19937 generator(2020);
+    vector<SongState> songs(numberOfSongs);
+    for (SongState &song : songs) {
+        song.artistID = (int) (generator() % numberOfArtists);
+        song.plays = 0;
+    }
+
+    // 90% AddToSongCount skewed towards popular songs, 8% rank queries and
+    // 2% new songs
+    vector<int> operations(numberOfOperations);
+    vector<int> targets(numberOfOperations);
+    for (int i = 0; i < numberOfOperations; ++i) {
+        int kind = (int) (generator() % 100);
+        operations[i] = kind < 90 ? 0 : (kind < 98 ? 1 : 2);
+        long long first = generator() % numberOfSongs;
+        long long second = generator() % numberOfSongs;
+        targets[i] = (int) (first * second / numberOfSongs);
+    }
+
+    Benchmark<AvlBalance>("AVL", songs, numberOfArtists, operations, targets);
+    Benchmark<RedBlackBalance>("red-black", songs, numberOfArtists, operations, targets);
+    Benchmark<TreapBalance>("treap", songs, numberOfArtists, operations, targets);
+    return 0;
+}
@@ -0,0 +1,87 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+// Compares the hash policies of HashTable on sequential and random artist IDs
+// usage: ./hash_benchmark [number of keys]
+
+#include "../HashTable.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class H>
+static void BenchmarkHashOnly(const char *name, const char *keysName, const vector<int> &keys) {
+    H hash;
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (int key : keys) {
+            sum += hash(key) >> 57;
+        }
+    }
+    double ms = ElapsedMs(start);
+    printf("%-16s %-10s hash only:   %8.2f ns/key (checksum %llu)\n", name, keysName, ms * 1e6 / (10.0 * keys.size()),
+           (unsigned long long) sum);
+}
+
+template<class H>
+static void BenchmarkTable(const char *name, const char *keysName, const vector<int> &keys) {
+    HashTable<int, H> table;
+    auto start = std::chrono::steady_clock::now();
+    for (int key : keys) {
+        table.Insert(key, int(key));
+    }
+    double insertMs = ElapsedMs(start);
+
+    long long found = 0;
+    start = std::chrono::steady_clock::now();
+    for (int key : keys) {
+        found += *table.FindData(key);
+    }
+    double findMs = ElapsedMs(start);
+    printf("%-16s %-10s table insert: %8.2f ns/key, find: %8.2f ns/key (checksum %lld)\n", name, keysName,
+           insertMs * 1e6 / keys.size(), findMs * 1e6 / keys.size(), found);
+}
+
+template<class H>
+static void Benchmark(const char *name, const vector<int> &sequential, const vector<int> &random) {
+    BenchmarkHashOnly<H>(name, "sequential", sequential);
+    BenchmarkHashOnly<H>(name, "random", random);
+    BenchmarkTable<H>(name, "sequential", sequential);
+    BenchmarkTable<H>(name, "random", random);
+}
+
+int main(int argc, const char **argv) {
+    int numberOfKeys = 1000000;
+    if (argc > 1) {
+        numberOfKeys = atoi(argv[1]);
+    }
+
+    vector<int> sequential(numberOfKeys);
+    for (int i = 0; i < numberOfKeys; ++i) {
+        sequential[i] = i + 1;
+    }
+    // Distinct random positive IDs, using a shuffled range of the whole int space
+    vector<int> random(numberOfKeys);
+    std::mt19937 generator(2020);
+    int stride = 0x7FFFFFFF / numberOfKeys;
+    for (int i = 0; i < numberOfKeys; ++i) {
+        random[i] = 1 + i * stride + (int) (generator() % stride);
+    }
+    std::shuffle(random.begin(), random.end(), generator);
+
+    Benchmark<GoldenRatioHash>("GoldenRatioHash", sequential, random);
+    Benchmark<FibonacciHash>("FibonacciHash", sequential, random);
+    Benchmark<SeededHash>("SeededHash", sequential, random);
+    return 0;
+}
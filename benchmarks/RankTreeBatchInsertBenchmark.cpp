@@ -0,0 +1,91 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+// Compares inserting a batch of keys into a large RankTree key by key with
+// InsertBatch, for keys scattered over the tree and for keys in one cluster
+// usage: ./rank_tree_batch_insert_benchmark [number of keys in the tree] [number of inserted keys]
+
+#include "../RankTree.h"
+#include "../ThreeParamKey.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static RankTree<ThreeParamKey, int> *BuildTree(const vector<ThreeParamKey> &keys) {
+    vector<int *> data(keys.size(), nullptr);
+    int **dataArray = data.data();
+    return new RankTree<ThreeParamKey, int>(keys.data(), dataArray, (int) keys.size());
+}
+
+static void Benchmark(const char *name, const vector<ThreeParamKey> &treeKeys,
+                      const vector<ThreeParamKey> &insertedKeys) {
+    RankTree<ThreeParamKey, int> *tree = BuildTree(treeKeys);
+    auto start = std::chrono::steady_clock::now();
+    for (const ThreeParamKey &key : insertedKeys) {
+        tree->Insert(key, nullptr);
+    }
+    double insertMs = ElapsedMs(start);
+    int insertSize = tree->GetRoot()->getRank();
+    delete tree;
+
+    tree = BuildTree(treeKeys);
+    start = std::chrono::steady_clock::now();
+    tree->InsertBatch(insertedKeys.data(), (int) insertedKeys.size());
+    double batchMs = ElapsedMs(start);
+    int batchSize = tree->GetRoot()->getRank();
+    delete tree;
+
+    printf("%-10s Insert: %8.1f ms (%6.1f ns/key), InsertBatch: %8.1f ms (%6.1f ns/key), sizes %d %d\n", name,
+           insertMs, insertMs * 1e6 / insertedKeys.size(), batchMs, batchMs * 1e6 / insertedKeys.size(),
+           insertSize, batchSize);
+}
+
+int main(int argc, const char **argv) {
+    int numberOfKeys = 10000000;
+    int numberOfInserted = 1000000;
+    if (argc > 1) {
+        numberOfKeys = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        numberOfInserted = atoi(argv[2]);
+    }
+
+    // The tree holds songs with even IDs in key order, every scattered song has
+    // an odd ID and lands next to one of them
+    std::mt19937 generator(2020);
+    vector<ThreeParamKey> treeKeys;
+    treeKeys.reserve(numberOfKeys);
+    for (int i = 0; i < numberOfKeys; ++i) {
+        treeKeys.push_back(ThreeParamKey(i / 100, 200 - 2 * (i % 100), 1));
+    }
+
+    vector<ThreeParamKey> scattered;
+    scattered.reserve(numberOfInserted);
+    for (int i = 0; i < numberOfInserted; ++i) {
+        int position = (int) (generator() % numberOfKeys);
+        scattered.push_back(ThreeParamKey(position / 100, 199 - 2 * (position % 100), 1));
+    }
+    std::shuffle(scattered.begin(), scattered.end(), generator);
+
+    // Songs ranked below every song of the tree, all of them land at the same spot
+    vector<ThreeParamKey> clustered;
+    clustered.reserve(numberOfInserted);
+    for (int i = 0; i < numberOfInserted; ++i) {
+        clustered.push_back(ThreeParamKey(-1, i + 1, 1));
+    }
+    std::shuffle(clustered.begin(), clustered.end(), generator);
+
+    Benchmark("scattered", treeKeys, scattered);
+    Benchmark("clustered", treeKeys, clustered);
+    return 0;
+}
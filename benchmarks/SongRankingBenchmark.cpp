@@ -0,0 +1,86 @@
+//
+// Created by Mor on 03/06/2020.
+//
+
+// Compares the AVL RankTree with the counted B+tree as the global song ranking,
+// both as key-only sets like in the library
+// usage: ./song_ranking_benchmark [number of songs] [number of operations]
+
+#include "../RankTree.h"
+#include "../CountedBPlusTree.h"
+#include "../ThreeParamKey.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class R>
+static void Benchmark(const char *name, vector<ThreeParamKey> songs, const vector<int> &ranks,
+                      const vector<int> &updated) {
+    R ranking;
+    auto start = std::chrono::steady_clock::now();
+    for (const ThreeParamKey &song : songs) {
+        ranking.Insert(song, nullptr);
+    }
+    double insertMs = ElapsedMs(start);
+
+    long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int rank : ranks) {
+        checksum += ranking.FindByRank(rank).getSongId();
+    }
+    double rankMs = ElapsedMs(start);
+
+    // An AddToSongCount moves the song to it's new number of plays
+    start = std::chrono::steady_clock::now();
+    for (int index : updated) {
+        ThreeParamKey &song = songs[index];
+        ranking.Remove(song);
+        song.setNumberOfPlays(song.getNumberOfPlays() + 1 + index % 7);
+        ranking.Insert(song, nullptr);
+    }
+    double updateMs = ElapsedMs(start);
+
+    printf("%-16s insert: %8.1f ns/song, find by rank: %8.1f ns/op, update: %8.1f ns/op (checksum %lld)\n", name,
+           insertMs * 1e6 / songs.size(), rankMs * 1e6 / ranks.size(), updateMs * 1e6 / updated.size(), checksum);
+}
+
+int main(int argc, const char **argv) {
+    int numberOfSongs = 10000000;
+    int numberOfOperations = 1000000;
+    if (argc > 1) {
+        numberOfSongs = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        numberOfOperations = atoi(argv[2]);
+    }
+
+    // Songs of 100000 artists with a skewed number of plays, inserted in a random order
+    std::mt19937 generator(2020);
+    vector<ThreeParamKey> songs;
+    songs.reserve(numberOfSongs);
+    for (int i = 0; i < numberOfSongs; ++i) {
+        int plays = (int) (generator() % 1000) * (int) (generator() % 1000) / 1000;
+        songs.push_back(ThreeParamKey(plays, i + 1, (int) (generator() % 100000) + 1));
+    }
+    std::shuffle(songs.begin(), songs.end(), generator);
+
+    vector<int> ranks(numberOfOperations);
+    vector<int> updated(numberOfOperations);
+    for (int i = 0; i < numberOfOperations; ++i) {
+        ranks[i] = 1 + (int) (generator() % numberOfSongs);
+        updated[i] = (int) (generator() % numberOfSongs);
+    }
+
+    Benchmark<RankTree<ThreeParamKey, void>>("RankTree", songs, ranks, updated);
+    Benchmark<CountedBPlusTree<ThreeParamKey, void>>("CountedBPlusTree", songs, ranks, updated);
+    return 0;
+}
@@ -21,6 +21,18 @@ void *Init() {
     }
 }
 
+void *InitWithCapacity(int numberOfArtists) {
+    if (numberOfArtists < 0) {
+        return nullptr;
+    }
+    try {
+        MusicManager *DS = new MusicManager(numberOfArtists);
+        return (void *) DS;
+    } catch (std::bad_alloc &e) {
+        return nullptr;
+    }
+}
+
 StatusType AddArtist(void *DS, int artistID) {
     if (!DS || artistID <= 0) {
         return INVALID_INPUT;
@@ -45,6 +57,23 @@ StatusType AddSong(void *DS, int artistID, int songID) {
     return nDS->AddSong(artistID, songID);
 }
 
+StatusType AddSongs(void *DS, int artistID, const int *songIDs, int n) {
+    if (!DS || artistID <= 0 || !songIDs || n <= 0) {
+        return INVALID_INPUT;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (songIDs[i] <= 0) {
+            return INVALID_INPUT;
+        }
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    try {
+        return nDS->AddSongs(artistID, songIDs, n);
+    } catch (std::bad_alloc &e) {
+        return ALLOCATION_ERROR;
+    }
+}
+
 StatusType RemoveSong(void *DS, int artistID, int songID) {
     if (!DS || artistID <= 0 || songID <= 0) {
         return INVALID_INPUT;
@@ -53,6 +82,30 @@ StatusType RemoveSong(void *DS, int artistID, int songID) {
     return nDS->RemoveSong(artistID, songID);
 }
 
+StatusType MergeArtists(void *DS, int srcArtistID, int dstArtistID) {
+    if (!DS || srcArtistID <= 0 || dstArtistID <= 0 || srcArtistID == dstArtistID) {
+        return INVALID_INPUT;
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    try {
+        return nDS->MergeArtists(srcArtistID, dstArtistID);
+    } catch (std::bad_alloc &e) {
+        return ALLOCATION_ERROR;
+    }
+}
+
+StatusType RemoveSongsWithPlaysBelow(void *DS, int numberOfPlays) {
+    if (!DS || numberOfPlays <= 0) {
+        return INVALID_INPUT;
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    try {
+        return nDS->RemoveSongsWithPlaysBelow(numberOfPlays);
+    } catch (std::bad_alloc &e) {
+        return ALLOCATION_ERROR;
+    }
+}
+
 StatusType AddToSongCount(void *DS, int artistID, int songID, int count) {
     if (!DS || artistID <= 0 || songID <= 0 || count <= 0) {
         return INVALID_INPUT;
@@ -77,6 +130,42 @@ StatusType GetRecommendedSongInPlace(void *DS, int rank, int *artistID, int *son
     return nDS->GetRecommendedSongInPlace(rank, artistID, songID);
 }
 
+StatusType AddToSongCountBatch(void *DS, int n, const int *artistIDs, const int *songIDs, const int *counts,
+                               StatusType *results) {
+    if (!DS || n < 0 || !artistIDs || !songIDs || !counts || !results) {
+        return INVALID_INPUT;
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    return nDS->AddToSongCountBatch(n, artistIDs, songIDs, counts, results);
+}
+
+StatusType GetArtistBestSongBatch(void *DS, int n, const int *artistIDs, int *songIDs, StatusType *results) {
+    if (!DS || n < 0 || !artistIDs || !songIDs || !results) {
+        return INVALID_INPUT;
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    return nDS->GetArtistBestSongBatch(n, artistIDs, songIDs, results);
+}
+
+StatusType CompactNodes(void *DS, int budget, int *isDone) {
+    if (!DS || budget <= 0 || !isDone) {
+        return INVALID_INPUT;
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    bool isPassDone = false;
+    StatusType result = nDS->CompactNodes(budget, &isPassDone);
+    *isDone = isPassDone ? 1 : 0;
+    return result;
+}
+
+StatusType Reset(void *DS) {
+    if (!DS) {
+        return INVALID_INPUT;
+    }
+    MusicManager *nDS = static_cast<MusicManager *>(DS);
+    return nDS->Reset();
+}
+
 void Quit(void **DS) {
     MusicManager *nDS = static_cast<MusicManager *>(*DS);
     delete nDS;
@@ -30,20 +30,46 @@ typedef enum {
 
 void *Init();
 
+void *InitWithCapacity(int numberOfArtists);
+
 StatusType AddArtist(void *DS, int artistID);
 
 StatusType RemoveArtist(void *DS, int artistID);
 
 StatusType AddSong(void *DS, int artistID, int songID);
 
+/* Adds n new songs to an artist, either all of them or none of them */
+StatusType AddSongs(void *DS, int artistID, const int *songIDs, int n);
+
 StatusType RemoveSong(void *DS, int artistID, int songID);
 
+/* Moves all the songs of srcArtistID to dstArtistID and removes srcArtistID,
+ * a song both artists have keeps the plays of both */
+StatusType MergeArtists(void *DS, int srcArtistID, int dstArtistID);
+
+/* Removes every song with fewer than numberOfPlays plays from all artists */
+StatusType RemoveSongsWithPlaysBelow(void *DS, int numberOfPlays);
+
 StatusType AddToSongCount(void *DS, int artistID, int songID, int count);
 
 StatusType GetArtistBestSong(void *DS, int artistID, int *songId);
 
 StatusType GetRecommendedSongInPlace(void *DS, int rank, int *artistId, int *songId);
 
+/* Batched variants, every operation i gets it's own result in results[i],
+ * identical to calling the single operation n times in order */
+StatusType AddToSongCountBatch(void *DS, int n, const int *artistIDs, const int *songIDs, const int *counts,
+                               StatusType *results);
+
+StatusType GetArtistBestSongBatch(void *DS, int n, const int *artistIDs, int *songIds, StatusType *results);
+
+/* Runs a slice of a pass that packs the songs and tree nodes into dense
+ * memory, visiting about budget keys, *isDone is set to 1 once the pass is over */
+StatusType CompactNodes(void *DS, int budget, int *isDone);
+
+/* Removes every artist and song, the DS stays valid and empty */
+StatusType Reset(void *DS);
+
 void Quit(void** DS);
 
 #ifdef __cplusplus
@@ -14,6 +14,7 @@
 /***************************************************************************/
 
 #include <assert.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -35,10 +36,18 @@ typedef enum {
 	ADDTOSONGCOUNT_CMD = 5,
 	GETARTISTBESTSONG_CMD = 6,
 	GETRECOMMENDEDSONGINPLACE_CMD = 7,
-    QUIT_CMD = 8
+    QUIT_CMD = 8,
+    ADDSONGS_CMD = 9,
+    MERGEARTISTS_CMD = 10,
+    REMOVESONGSWITHPLAYSBELOW_CMD = 11,
+    ADDTOSONGCOUNTBATCH_CMD = 12,
+    GETARTISTBESTSONGBATCH_CMD = 13,
+    INITWITHCAPACITY_CMD = 14,
+    COMPACTNODES_CMD = 15,
+    RESET_CMD = 16
 } commandType;
 
-static const int numActions = 9;
+static const int numActions = 17;
 static const char *commandStr[] = {
         "Init",
 		"AddArtist",
@@ -48,7 +57,15 @@ static const char *commandStr[] = {
         "AddToSongCount",
         "GetArtistBestSong",
         "GetRecommendedSongInPlace",
-        "Quit" };
+        "Quit",
+        "AddSongs",
+        "MergeArtists",
+        "RemoveSongsWithPlaysBelow",
+        "AddToSongCountBatch",
+        "GetArtistBestSongBatch",
+        "InitWithCapacity",
+        "CompactNodes",
+        "Reset" };
 
 static const char* ReturnValToStr(int val) {
     switch (val) {
@@ -68,6 +85,8 @@ static const char* ReturnValToStr(int val) {
 /* we assume maximum string size is not longer than 256  */
 #define MAX_STRING_INPUT_SIZE (255)
 #define MAX_BUFFER_SIZE       (255)
+/* maximum number of values a single batch command reads */
+#define MAX_BATCH_SIZE        (64)
 
 #define StrCmp(Src1,Src2) ( strncmp((Src1),(Src2),strlen(Src1)) == 0 )
 
@@ -112,7 +131,9 @@ static commandType CheckCommand(const char* const command,
         return (COMMENT_CMD);
     };
     for (int index = 0; index < numActions; index++) {
-        if (StrCmp(commandStr[index], command)) {
+        // The whole word has to match, "AddSong" is a prefix of "AddSongs"
+        char after = command[strlen(commandStr[index])];
+        if (StrCmp(commandStr[index], command) && (after == '\0' || isspace(after))) {
             *command_arg = command + strlen(commandStr[index]) + 1;
             return ((commandType)index);
         };
@@ -133,6 +154,14 @@ static errorType OnAddToSongCount(void* DS, const char* const command);
 static errorType OnGetArtistBestSong(void* DS, const char* const command);
 static errorType OnGetRecommendedSongInPlace(void* DS, const char* const command);
 static errorType OnQuit(void** DS, const char* const command);
+static errorType OnAddSongs(void* DS, const char* const command);
+static errorType OnMergeArtists(void* DS, const char* const command);
+static errorType OnRemoveSongsWithPlaysBelow(void* DS, const char* const command);
+static errorType OnAddToSongCountBatch(void* DS, const char* const command);
+static errorType OnGetArtistBestSongBatch(void* DS, const char* const command);
+static errorType OnInitWithCapacity(void** DS, const char* const command);
+static errorType OnCompactNodes(void* DS, const char* const command);
+static errorType OnReset(void* DS, const char* const command);
 
 /***************************************************************************/
 /* Parser                                                                  */
@@ -174,6 +203,30 @@ static errorType parser(const char* const command) {
         case (QUIT_CMD):
             rtn_val = OnQuit(&DS, command_args);
             break;
+        case (ADDSONGS_CMD):
+            rtn_val = OnAddSongs(DS, command_args);
+            break;
+        case (MERGEARTISTS_CMD):
+            rtn_val = OnMergeArtists(DS, command_args);
+            break;
+        case (REMOVESONGSWITHPLAYSBELOW_CMD):
+            rtn_val = OnRemoveSongsWithPlaysBelow(DS, command_args);
+            break;
+        case (ADDTOSONGCOUNTBATCH_CMD):
+            rtn_val = OnAddToSongCountBatch(DS, command_args);
+            break;
+        case (GETARTISTBESTSONGBATCH_CMD):
+            rtn_val = OnGetArtistBestSongBatch(DS, command_args);
+            break;
+        case (INITWITHCAPACITY_CMD):
+            rtn_val = OnInitWithCapacity(&DS, command_args);
+            break;
+        case (COMPACTNODES_CMD):
+            rtn_val = OnCompactNodes(DS, command_args);
+            break;
+        case (RESET_CMD):
+            rtn_val = OnReset(DS, command_args);
+            break;
 
         case (COMMENT_CMD):
             rtn_val = error_free;
@@ -318,6 +371,141 @@ static errorType OnQuit(void** DS, const char* const command) {
     return error_free;
 }
 
+/* Reads count integers one after the other, returns how many were read */
+static int ReadInts(const char* command, int* values, int count) {
+    int read = 0, consumed = 0;
+    while (read < count && sscanf(command, "%d%n", &values[read], &consumed) == 1) {
+        command += consumed;
+        read++;
+    }
+    return read;
+}
+
+static errorType OnAddSongs(void* DS, const char* const command) {
+    int artistId, n, consumed = 0;
+    int songIds[MAX_BATCH_SIZE];
+    ValidateRead(sscanf(command, "%d %d%n", &artistId, &n, &consumed), 2, "%s failed.\n", commandStr[ADDSONGS_CMD]);
+    ValidateRead(n <= MAX_BATCH_SIZE, true, "%s failed.\n", commandStr[ADDSONGS_CMD]);
+    int toRead = n > 0 ? n : 0;
+    ValidateRead(ReadInts(command + consumed, songIds, toRead), toRead, "%s failed.\n", commandStr[ADDSONGS_CMD]);
+    StatusType res = AddSongs(DS, artistId, songIds, n);
+
+    printf("%s: %s\n", commandStr[ADDSONGS_CMD], ReturnValToStr(res));
+    return error_free;
+}
+
+static errorType OnMergeArtists(void* DS, const char* const command) {
+    int srcArtistId, dstArtistId;
+    ValidateRead(sscanf(command, "%d %d", &srcArtistId, &dstArtistId), 2, "%s failed.\n", commandStr[MERGEARTISTS_CMD]);
+    StatusType res = MergeArtists(DS, srcArtistId, dstArtistId);
+
+    printf("%s: %s\n", commandStr[MERGEARTISTS_CMD], ReturnValToStr(res));
+    return error_free;
+}
+
+static errorType OnRemoveSongsWithPlaysBelow(void* DS, const char* const command) {
+    int numberOfPlays;
+    ValidateRead(sscanf(command, "%d", &numberOfPlays), 1, "%s failed.\n", commandStr[REMOVESONGSWITHPLAYSBELOW_CMD]);
+    StatusType res = RemoveSongsWithPlaysBelow(DS, numberOfPlays);
+
+    printf("%s: %s\n", commandStr[REMOVESONGSWITHPLAYSBELOW_CMD], ReturnValToStr(res));
+    return error_free;
+}
+
+/* Every operation prints a line of it's own, as if the single command was called */
+static errorType OnAddToSongCountBatch(void* DS, const char* const command) {
+    int n, consumed = 0;
+    int values[3 * MAX_BATCH_SIZE];
+    int artistIds[MAX_BATCH_SIZE], songIds[MAX_BATCH_SIZE], counts[MAX_BATCH_SIZE];
+    StatusType results[MAX_BATCH_SIZE];
+    ValidateRead(sscanf(command, "%d%n", &n, &consumed), 1, "%s failed.\n", commandStr[ADDTOSONGCOUNTBATCH_CMD]);
+    ValidateRead(n <= MAX_BATCH_SIZE, true, "%s failed.\n", commandStr[ADDTOSONGCOUNTBATCH_CMD]);
+    int toRead = n > 0 ? 3 * n : 0;
+    ValidateRead(ReadInts(command + consumed, values, toRead), toRead, "%s failed.\n", commandStr[ADDTOSONGCOUNTBATCH_CMD]);
+    for (int i = 0; i < toRead / 3; i++) {
+        artistIds[i] = values[3 * i];
+        songIds[i] = values[3 * i + 1];
+        counts[i] = values[3 * i + 2];
+    }
+    StatusType res = AddToSongCountBatch(DS, n, artistIds, songIds, counts, results);
+
+    if (res != SUCCESS) {
+        printf("%s: %s\n", commandStr[ADDTOSONGCOUNTBATCH_CMD], ReturnValToStr(res));
+        return error_free;
+    }
+
+    for (int i = 0; i < n; i++) {
+        printf("%s: %s\n", commandStr[ADDTOSONGCOUNTBATCH_CMD], ReturnValToStr(results[i]));
+    }
+    return error_free;
+}
+
+static errorType OnGetArtistBestSongBatch(void* DS, const char* const command) {
+    int n, consumed = 0;
+    int artistIds[MAX_BATCH_SIZE], songIds[MAX_BATCH_SIZE];
+    StatusType results[MAX_BATCH_SIZE];
+    ValidateRead(sscanf(command, "%d%n", &n, &consumed), 1, "%s failed.\n", commandStr[GETARTISTBESTSONGBATCH_CMD]);
+    ValidateRead(n <= MAX_BATCH_SIZE, true, "%s failed.\n", commandStr[GETARTISTBESTSONGBATCH_CMD]);
+    int toRead = n > 0 ? n : 0;
+    ValidateRead(ReadInts(command + consumed, artistIds, toRead), toRead, "%s failed.\n", commandStr[GETARTISTBESTSONGBATCH_CMD]);
+    StatusType res = GetArtistBestSongBatch(DS, n, artistIds, songIds, results);
+
+    if (res != SUCCESS) {
+        printf("%s: %s\n", commandStr[GETARTISTBESTSONGBATCH_CMD], ReturnValToStr(res));
+        return error_free;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (results[i] != SUCCESS) {
+            printf("%s: %s\n", commandStr[GETARTISTBESTSONGBATCH_CMD], ReturnValToStr(results[i]));
+        } else {
+            printf("%s: %d\n", commandStr[GETARTISTBESTSONGBATCH_CMD], songIds[i]);
+        }
+    }
+    return error_free;
+}
+
+static errorType OnInitWithCapacity(void** DS, const char* const command) {
+    if (isInit) {
+        printf("init was already called.\n");
+        return (error_free);
+    };
+
+    int numberOfArtists;
+    ValidateRead(sscanf(command, "%d", &numberOfArtists), 1, "%s failed.\n", commandStr[INITWITHCAPACITY_CMD]);
+    *DS = InitWithCapacity(numberOfArtists);
+
+    if (*DS == NULL) {
+        printf("init failed.\n");
+        return error;
+    };
+
+    isInit = true;
+    printf("init done.\n");
+    return error_free;
+}
+
+static errorType OnCompactNodes(void* DS, const char* const command) {
+    int budget, isDone;
+    ValidateRead(sscanf(command, "%d", &budget), 1, "%s failed.\n", commandStr[COMPACTNODES_CMD]);
+    StatusType res = CompactNodes(DS, budget, &isDone);
+
+    if (res != SUCCESS) {
+        printf("%s: %s\n", commandStr[COMPACTNODES_CMD], ReturnValToStr(res));
+        return error_free;
+    }
+
+    printf("%s: %s\n", commandStr[COMPACTNODES_CMD], isDone ? "done" : "not done");
+    return error_free;
+}
+
+static errorType OnReset(void* DS, const char* const command) {
+    StatusType res = Reset(DS);
+
+    printf("%s: %s\n", commandStr[RESET_CMD], ReturnValToStr(res));
+    return error_free;
+}
+
 #ifdef __cplusplus
 }
 #endif